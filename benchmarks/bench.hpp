@@ -0,0 +1,184 @@
+#ifndef FLOATING_POINTERS_BENCH_HPP
+#define FLOATING_POINTERS_BENCH_HPP
+
+// Minimal benchmarking support shared by the benchmark executables: wall clock timing, hardware counters through
+// perf_event_open, and a few helpers to keep the optimizer honest.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+namespace bench {
+    template<typename T> inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    inline void clobber() {
+        asm volatile("" : : : "memory");
+    }
+
+    // Reads a size from the environment so long runs can be scaled down (or up) without recompiling.
+    inline std::size_t env_size(const char* name, std::size_t fallback) {
+        const char* value = std::getenv(name);
+        return value ? std::strtoull(value, nullptr, 0) : fallback;
+    }
+
+    // A single hardware counter for the calling thread. Counting is silently disabled when the kernel refuses the
+    // event (no PMU in a VM, perf_event_paranoid, seccomp), in which case valid() is false and reads return 0.
+    class perf_counter {
+        int fd = -1;
+    public:
+        perf_counter(std::uint32_t type, std::uint64_t config) {
+            #if defined(__linux__)
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            #else
+            (void)type;
+            (void)config;
+            #endif
+        }
+        perf_counter(const perf_counter&) = delete;
+        perf_counter& operator=(const perf_counter&) = delete;
+        ~perf_counter() {
+            #if defined(__linux__)
+            if(fd >= 0) {
+                close(fd);
+            }
+            #endif
+        }
+        bool valid() const {
+            return fd >= 0;
+        }
+        void start() {
+            #if defined(__linux__)
+            if(fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+            #endif
+        }
+        std::uint64_t stop() {
+            std::uint64_t count = 0;
+            #if defined(__linux__)
+            if(fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                if(read(fd, &count, sizeof(count)) != sizeof(count)) {
+                    count = 0;
+                }
+            }
+            #endif
+            return count;
+        }
+    };
+
+    inline perf_counter instruction_counter() {
+        #if defined(__linux__)
+        return perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        #else
+        return perf_counter(0, 0);
+        #endif
+    }
+
+    inline perf_counter llc_miss_counter() {
+        #if defined(__linux__)
+        return perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        #else
+        return perf_counter(0, 0);
+        #endif
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    inline double elapsed_ns(clock::time_point start, clock::time_point end) {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    struct measurement {
+        double ns_per_op;
+        double events_per_op; // negative when the counter is unavailable
+    };
+
+    // Runs f() (which performs ops operations) repeatedly and keeps the fastest repetition. The counter, if valid, is
+    // sampled over the same repetition that produced the reported time.
+    template<typename F>
+    measurement measure(std::size_t ops, perf_counter& counter, F&& f, int repetitions = 7) {
+        f(); // warm up caches and branch predictors
+        measurement best{1e300, -1};
+        for(int i = 0; i < repetitions; i++) {
+            counter.start();
+            auto start = clock::now();
+            f();
+            auto end = clock::now();
+            std::uint64_t events = counter.stop();
+            double ns = elapsed_ns(start, end) / double(ops);
+            if(ns < best.ns_per_op) {
+                best.ns_per_op = ns;
+                best.events_per_op = counter.valid() ? double(events) / double(ops) : -1;
+            }
+        }
+        return best;
+    }
+
+    inline std::string format_events(double events) {
+        if(events < 0) {
+            return "n/a";
+        }
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f", events);
+        return buffer;
+    }
+
+    // Nearest-rank percentile, p in [0, 100]. Sorts the samples in place.
+    inline double percentile(std::vector<double>& samples, double p) {
+        if(samples.empty()) {
+            return 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        std::size_t rank = std::size_t(p / 100 * double(samples.size() - 1) + 0.5);
+        return samples[std::min(rank, samples.size() - 1)];
+    }
+
+    // xorshift64*, deterministic across runs and platforms.
+    class rng {
+        std::uint64_t state;
+    public:
+        explicit rng(std::uint64_t seed = 0x9e3779b97f4a7c15) : state(seed ? seed : 1) {}
+        std::uint64_t operator()() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 0x2545f4914f6cdd1d;
+        }
+        std::uint64_t below(std::uint64_t bound) {
+            return (*this)() % bound;
+        }
+    };
+
+    template<typename T> void shuffle(std::vector<T>& values, rng& random) {
+        for(std::size_t i = values.size(); i > 1; i--) {
+            std::swap(values[i - 1], values[random.below(i)]);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,129 @@
+// Benchmark: standard containers with floating_allocator<T> against std::allocator<T>, and against
+// std::pmr::polymorphic_allocator<T> over the same resource to separate the cost of the floating pointers from the
+// cost of going through a memory resource.
+//
+// Environment: BENCH_ELEMENTS (elements per container, default 1<<20).
+
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include <floating_allocator.hpp>
+
+#include "bench.hpp"
+
+using based::floating_allocator;
+
+namespace {
+    using key = std::uint64_t;
+
+    template<template<typename> class A> struct allocator_family;
+    template<> struct allocator_family<std::allocator> {
+        static constexpr const char* name = "std::allocator";
+    };
+    template<> struct allocator_family<std::pmr::polymorphic_allocator> {
+        static constexpr const char* name = "pmr::polymorphic_allocator";
+    };
+    template<> struct allocator_family<floating_allocator> {
+        static constexpr const char* name = "floating_allocator";
+    };
+
+    template<template<typename> class A>
+    double vector_push_back(std::size_t count) {
+        auto counter = bench::instruction_counter();
+        return bench::measure(count, counter, [&] {
+            std::vector<key, A<key>> v;
+            for(std::size_t i = 0; i < count; i++) {
+                v.push_back(i);
+            }
+            bench::do_not_optimize(v.data());
+        }).ns_per_op;
+    }
+
+    template<template<typename> class A>
+    double vector_iterate(std::size_t count) {
+        std::vector<key, A<key>> v(count, 1);
+        auto counter = bench::instruction_counter();
+        return bench::measure(count, counter, [&] {
+            key sum = 0;
+            for(auto it = v.begin(); it != v.end(); ++it) {
+                sum += *it;
+            }
+            bench::do_not_optimize(sum);
+        }).ns_per_op;
+    }
+
+    // Moves chunks of one list into another and back again, node by node, so every splice relinks pointers.
+    template<template<typename> class A>
+    double list_splice(std::size_t count) {
+        std::list<key, A<key>> from, to;
+        for(std::size_t i = 0; i < count; i++) {
+            from.push_back(i);
+        }
+        auto counter = bench::instruction_counter();
+        return bench::measure(2 * count, counter, [&] {
+            while(!from.empty()) {
+                to.splice(to.begin(), from, from.begin());
+            }
+            while(!to.empty()) {
+                from.splice(from.end(), to, to.begin());
+            }
+        }).ns_per_op;
+    }
+
+    template<template<typename> class A>
+    using map_type = std::map<key, key, std::less<key>, A<std::pair<const key, key>>>;
+
+    template<template<typename> class A>
+    double map_insert(const std::vector<key>& keys) {
+        auto counter = bench::instruction_counter();
+        return bench::measure(keys.size(), counter, [&] {
+            map_type<A> m;
+            for(key k : keys) {
+                m.emplace(k, k);
+            }
+            bench::do_not_optimize(m.size());
+        }, 3).ns_per_op;
+    }
+
+    template<template<typename> class A>
+    double map_lookup(const std::vector<key>& keys) {
+        map_type<A> m;
+        for(key k : keys) {
+            m.emplace(k, k);
+        }
+        auto counter = bench::instruction_counter();
+        return bench::measure(keys.size(), counter, [&] {
+            key sum = 0;
+            for(key k : keys) {
+                sum += m.find(k)->second;
+            }
+            bench::do_not_optimize(sum);
+        }, 3).ns_per_op;
+    }
+
+    template<template<typename> class A>
+    void run(std::size_t count, const std::vector<key>& keys) {
+        std::printf("%-28s %14.2f %14.2f %14.2f %14.2f %14.2f\n", allocator_family<A>::name, vector_push_back<A>(count),
+                    vector_iterate<A>(count), list_splice<A>(count), map_insert<A>(keys), map_lookup<A>(keys));
+    }
+}
+
+int main() {
+    std::size_t count = bench::env_size("BENCH_ELEMENTS", std::size_t(1) << 20);
+    std::vector<key> keys(count);
+    bench::rng random;
+    for(key& k : keys) {
+        k = random();
+    }
+    std::printf("ns per element, %zu elements\n", count);
+    std::printf("%-28s %14s %14s %14s %14s %14s\n", "allocator", "vec push_back", "vec iterate", "list splice",
+                "map insert", "map lookup");
+    run<std::allocator>(count, keys);
+    run<std::pmr::polymorphic_allocator>(count, keys);
+    run<floating_allocator>(count, keys);
+}
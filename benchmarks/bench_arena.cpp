@@ -0,0 +1,112 @@
+// Benchmark: building, walking and tearing down binary trees of floating_pointer<Node> allocated one node at a time
+// with new/delete against the same trees allocated from a floating_arena.
+//
+// Environment: BENCH_NODES (nodes per tree, default 1<<20).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <floating_arena.hpp>
+
+#include "bench.hpp"
+
+using based::floating_arena;
+using based::floating_pointer;
+
+namespace {
+    struct node {
+        floating_pointer<node> left;
+        floating_pointer<node> right;
+        std::uint64_t value;
+    };
+
+    // Inserts keys in random order so that new/delete sees a realistic interleaving of sizes and lifetimes.
+    template<typename Allocate>
+    floating_pointer<node> insert(floating_pointer<node> root, std::uint64_t value, Allocate&& allocate) {
+        floating_pointer<node> fresh = allocate(value);
+        if(!root) {
+            return fresh;
+        }
+        floating_pointer<node> it = root;
+        while(true) {
+            floating_pointer<node>& next = value < it->value ? it->left : it->right;
+            if(!next) {
+                next = fresh;
+                return root;
+            }
+            it = next;
+        }
+    }
+
+    std::uint64_t walk(floating_pointer<node> root) {
+        return root ? root->value + walk(root->left) + walk(root->right) : 0;
+    }
+
+    void destroy(floating_pointer<node> root) {
+        if(root) {
+            destroy(root->left);
+            destroy(root->right);
+            delete static_cast<node*>(root);
+        }
+    }
+
+    struct timings {
+        double build, walk, teardown;
+    };
+
+    template<typename Build, typename Teardown>
+    timings run(const std::vector<std::uint64_t>& keys, Build&& build, Teardown&& teardown) {
+        timings best{1e300, 1e300, 1e300};
+        for(int repetition = 0; repetition < 5; repetition++) {
+            auto t0 = bench::clock::now();
+            floating_pointer<node> root = build();
+            auto t1 = bench::clock::now();
+            bench::do_not_optimize(walk(root));
+            auto t2 = bench::clock::now();
+            teardown(root);
+            auto t3 = bench::clock::now();
+            double n = double(keys.size());
+            best.build = std::min(best.build, bench::elapsed_ns(t0, t1) / n);
+            best.walk = std::min(best.walk, bench::elapsed_ns(t1, t2) / n);
+            best.teardown = std::min(best.teardown, bench::elapsed_ns(t2, t3) / n);
+        }
+        return best;
+    }
+
+    void print_row(const char* name, const timings& t) {
+        std::printf("%-12s %12.2f %12.2f %12.2f\n", name, t.build, t.walk, t.teardown);
+    }
+}
+
+int main() {
+    std::size_t count = bench::env_size("BENCH_NODES", std::size_t(1) << 20);
+    std::vector<std::uint64_t> keys(count);
+    bench::rng random;
+    for(auto& key : keys) {
+        key = random();
+    }
+    std::printf("ns per node, %zu nodes\n", count);
+    std::printf("%-12s %12s %12s %12s\n", "allocation", "build", "walk", "teardown");
+    print_row("new/delete", run(keys, [&] {
+        floating_pointer<node> root = nullptr;
+        for(auto key : keys) {
+            root = insert(root, key, [](std::uint64_t value) {
+                return floating_pointer<node>(new node{nullptr, nullptr, value});
+            });
+        }
+        return root;
+    }, destroy));
+    floating_arena arena;
+    print_row("arena", run(keys, [&] {
+        floating_pointer<node> root = nullptr;
+        for(auto key : keys) {
+            root = insert(root, key, [&](std::uint64_t value) {
+                return arena.make<node>(node{nullptr, nullptr, value});
+            });
+        }
+        return root;
+    }, [&](floating_pointer<node>) { arena.release(); }));
+}
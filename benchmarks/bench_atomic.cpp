@@ -0,0 +1,167 @@
+// Benchmark: std::atomic<floating_pointer<T>> against std::atomic<T*>. First the uncontended cost of each operation on
+// one thread, then producer/consumer handoff latency: the producer publishes a pointer to the next message in an empty
+// slot, the consumer takes it and empties the slot, and the reported time is per message. Waiting spins with a yield,
+// blocks with C++20 wait/notify, or uses a mutex and condition variable.
+//
+// Environment: BENCH_OPS (single-threaded operations, default 1<<24), BENCH_HANDOFFS (messages, default 1<<16).
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <floating_atomic.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+
+namespace {
+    struct message {
+        std::uint64_t value;
+    };
+
+    template<typename Pointer>
+    void run_uncontended(const char* name, std::size_t ops) {
+        std::vector<message> messages(64);
+        std::atomic<Pointer> a(Pointer(messages.data()));
+        auto counter = bench::instruction_counter();
+        auto load = bench::measure(ops, counter, [&] {
+            for(std::size_t i = 0; i < ops; i++) {
+                bench::do_not_optimize(a.load(std::memory_order_acquire));
+            }
+        });
+        auto store = bench::measure(ops, counter, [&] {
+            for(std::size_t i = 0; i < ops; i++) {
+                a.store(Pointer(&messages[i & 63]), std::memory_order_release);
+            }
+        });
+        auto fetch_add = bench::measure(ops, counter, [&] {
+            a.store(Pointer(messages.data()));
+            for(std::size_t i = 0; i < ops; i++) {
+                a.fetch_add(1 - 2 * std::ptrdiff_t(i & 1));
+            }
+        });
+        auto cas = bench::measure(ops, counter, [&] {
+            Pointer expected = a.load();
+            for(std::size_t i = 0; i < ops; i++) {
+                a.compare_exchange_strong(expected, Pointer(&messages[i & 63]));
+            }
+        });
+        std::printf("%-34s %10.2f %10.2f %10.2f %10.2f\n", name, load.ns_per_op, store.ns_per_op, fetch_add.ns_per_op,
+                    cas.ns_per_op);
+    }
+
+    // Spins until the slot's emptiness is as wanted, yielding so the other side can run on a loaded machine
+    template<typename Pointer>
+    Pointer spin_until(std::atomic<Pointer>& slot, bool empty) {
+        for(;;) {
+            Pointer p = slot.load(std::memory_order_acquire);
+            if((p == nullptr) == empty) {
+                return p;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    template<typename Pointer>
+    double run_spin(std::vector<message>& messages) {
+        std::atomic<Pointer> slot(nullptr);
+        std::uint64_t sum = 0;
+        auto start = bench::clock::now();
+        std::thread consumer([&] {
+            for(std::size_t i = 0; i < messages.size(); i++) {
+                Pointer p = spin_until(slot, false);
+                sum += p->value;
+                slot.store(nullptr, std::memory_order_release);
+            }
+        });
+        for(auto& m : messages) {
+            spin_until(slot, true);
+            slot.store(Pointer(&m), std::memory_order_release);
+        }
+        consumer.join();
+        bench::do_not_optimize(sum);
+        return bench::elapsed_ns(start, bench::clock::now()) / double(messages.size());
+    }
+
+    #ifdef __cpp_lib_atomic_wait
+    template<typename Pointer>
+    double run_wait(std::vector<message>& messages) {
+        std::atomic<Pointer> slot(nullptr);
+        std::uint64_t sum = 0;
+        auto start = bench::clock::now();
+        std::thread consumer([&] {
+            for(std::size_t i = 0; i < messages.size(); i++) {
+                slot.wait(nullptr, std::memory_order_acquire);
+                sum += slot.load(std::memory_order_acquire)->value;
+                slot.store(nullptr, std::memory_order_release);
+                slot.notify_one();
+            }
+        });
+        for(auto& m : messages) {
+            Pointer p;
+            while((p = slot.load(std::memory_order_acquire)) != nullptr) {
+                slot.wait(p, std::memory_order_acquire);
+            }
+            slot.store(Pointer(&m), std::memory_order_release);
+            slot.notify_one();
+        }
+        consumer.join();
+        bench::do_not_optimize(sum);
+        return bench::elapsed_ns(start, bench::clock::now()) / double(messages.size());
+    }
+    #endif
+
+    double run_condition_variable(std::vector<message>& messages) {
+        std::mutex lock;
+        std::condition_variable changed;
+        floating_pointer<message> slot = nullptr;
+        std::uint64_t sum = 0;
+        auto start = bench::clock::now();
+        std::thread consumer([&] {
+            for(std::size_t i = 0; i < messages.size(); i++) {
+                std::unique_lock<std::mutex> guard(lock);
+                changed.wait(guard, [&] { return slot != nullptr; });
+                sum += slot->value;
+                slot = nullptr;
+                changed.notify_one();
+            }
+        });
+        for(auto& m : messages) {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [&] { return slot == nullptr; });
+            slot = &m;
+            changed.notify_one();
+        }
+        consumer.join();
+        bench::do_not_optimize(sum);
+        return bench::elapsed_ns(start, bench::clock::now()) / double(messages.size());
+    }
+}
+
+int main() {
+    std::size_t ops = bench::env_size("BENCH_OPS", std::size_t(1) << 24);
+    std::size_t handoffs = bench::env_size("BENCH_HANDOFFS", std::size_t(1) << 16);
+
+    std::printf("uncontended ns/op\n");
+    std::printf("%-34s %10s %10s %10s %10s\n", "atomic", "load", "store", "fetch_add", "cas");
+    run_uncontended<message*>("std::atomic<message*>", ops);
+    run_uncontended<floating_pointer<message>>("std::atomic<floating_pointer>", ops);
+
+    std::vector<message> messages(handoffs);
+    for(std::size_t i = 0; i < handoffs; i++) {
+        messages[i].value = i;
+    }
+    std::printf("\nhandoff ns/message, %zu messages\n", handoffs);
+    std::printf("%-34s %10.1f\n", "std::atomic<message*> spin", run_spin<message*>(messages));
+    std::printf("%-34s %10.1f\n", "std::atomic<floating_pointer> spin", run_spin<floating_pointer<message>>(messages));
+    #ifdef __cpp_lib_atomic_wait
+    std::printf("%-34s %10.1f\n", "std::atomic<message*> wait", run_wait<message*>(messages));
+    std::printf("%-34s %10.1f\n", "std::atomic<floating_pointer> wait", run_wait<floating_pointer<message>>(messages));
+    #endif
+    std::printf("%-34s %10.1f\n", "mutex + condition_variable", run_condition_variable(messages));
+}
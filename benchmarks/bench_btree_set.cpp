@@ -0,0 +1,93 @@
+// Benchmark: a set of live object addresses in floating_btree_set against std::set<T*>. Objects are heap allocated
+// one at a time, in random order relative to their addresses. Reported per operation: building the set by inserting
+// every object, looking up random live objects, scanning the next 64 keys from a random one as a range query, and
+// erasing and reinserting random objects. ns and LLC misses per operation.
+//
+// Environment: BENCH_KEYS (largest set, default 1<<22; sizes grow by 16x from 1<<10), BENCH_OPS (lookups, scans and
+// erase/insert pairs per measurement, default 1<<20).
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <floating_btree_set.hpp>
+
+#include "bench.hpp"
+
+using based::floating_btree_set;
+using based::floating_pointer;
+
+namespace {
+    struct object {
+        std::uint64_t payload[4];
+    };
+
+    void print(const char* operation, const char* container, std::size_t n, const bench::measurement& m) {
+        std::printf("%-8s %-20s %10zu %10.1f %10s\n", operation, container, n, m.ns_per_op,
+                    bench::format_events(m.events_per_op).c_str());
+    }
+
+    template<typename Set, typename Key>
+    void run(const char* name, const std::vector<Key>& objects, const std::vector<Key>& probes) {
+        std::size_t n = objects.size();
+        auto llc = bench::llc_miss_counter();
+        Set set;
+        print("insert", name, n, bench::measure(n, llc, [&] {
+            set = Set();
+            for(Key p : objects) {
+                set.insert(p);
+            }
+        }, 3));
+        print("find", name, n, bench::measure(probes.size(), llc, [&] {
+            std::size_t found = 0;
+            for(Key p : probes) {
+                found += set.find(p) != set.end();
+            }
+            bench::do_not_optimize(found);
+        }, 3));
+        print("scan 64", name, n, bench::measure(probes.size(), llc, [&] {
+            std::uintptr_t sum = 0;
+            for(Key p : probes) {
+                auto it = set.lower_bound(p);
+                for(int i = 0; i < 64 && it != set.end(); i++, ++it) {
+                    sum += std::uintptr_t(static_cast<object*>(*it));
+                }
+            }
+            bench::do_not_optimize(sum);
+        }, 3));
+        print("churn", name, n, bench::measure(probes.size(), llc, [&] {
+            for(Key p : probes) {
+                set.erase(p);
+                set.insert(p);
+            }
+        }, 3));
+    }
+}
+
+int main() {
+    std::size_t max_keys = bench::env_size("BENCH_KEYS", std::size_t(1) << 22);
+    std::size_t ops = bench::env_size("BENCH_OPS", std::size_t(1) << 20);
+    std::printf("%-8s %-20s %10s %10s %10s\n", "op", "container", "keys", "ns/op", "LLC/op");
+    for(std::size_t n = std::size_t(1) << 10; n <= max_keys; n *= 16) {
+        bench::rng random(n);
+        std::vector<std::unique_ptr<object>> storage(n);
+        for(auto& o : storage) {
+            o.reset(new object());
+        }
+        std::vector<object*> objects(n);
+        for(std::size_t i = 0; i < n; i++) {
+            objects[i] = storage[i].get();
+        }
+        bench::shuffle(objects, random);
+        std::vector<object*> probes(ops);
+        for(auto& p : probes) {
+            p = objects[random.below(n)];
+        }
+        run<std::set<object*>>("std::set<T*>", objects, probes);
+        std::vector<floating_pointer<object>> floating_objects(objects.begin(), objects.end());
+        std::vector<floating_pointer<object>> floating_probes(probes.begin(), probes.end());
+        run<floating_btree_set<object>>("floating_btree_set", floating_objects, floating_probes);
+    }
+}
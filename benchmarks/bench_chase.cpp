@@ -0,0 +1,259 @@
+// Macrobenchmark: pointer chasing through linked lists and binary trees of floating_pointer<Node> against identical
+// Node* structures, for several allocation orders.
+//
+// - sequential: nodes are laid out in traversal order
+// - shuffled:   nodes are packed into one array in random order
+// - scattered:  every node gets its own page, in random order, at a random cache line within the page
+//
+// List walks are split into fixed length segments and each segment is timed, so the percentiles are of the mean hop
+// latency within a segment. Tree walks time random root-to-leaf descents and whole invert_tree passes (the README
+// example). LLC misses come from the hardware cache-miss counter and are n/a when perf_event_open is unavailable.
+//
+// Environment: BENCH_NODES (list and tree size, default 1<<21), BENCH_SCATTER_NODES (cap for the scattered layout,
+// which costs a page per node, default 1<<16), BENCH_SEGMENT (hops per timed list segment, default 1024).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <floating_pointers.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+
+namespace {
+    struct raw_pointers {
+        static constexpr const char* name = "T*";
+        template<typename T> using pointer = T*;
+    };
+    struct floating_pointers {
+        static constexpr const char* name = "floating";
+        template<typename T> using pointer = floating_pointer<T>;
+    };
+
+    template<typename F> struct list_node {
+        typename F::template pointer<list_node> next;
+        std::uint64_t value;
+    };
+
+    template<typename F> struct tree_node {
+        typename F::template pointer<tree_node> left;
+        typename F::template pointer<tree_node> right;
+        std::uint64_t value;
+    };
+
+    enum class placement { sequential, shuffled, scattered };
+
+    const char* placement_name(placement order) {
+        switch(order) {
+            case placement::sequential: return "sequential";
+            case placement::shuffled: return "shuffled";
+            case placement::scattered: return "scattered";
+        }
+        return "?";
+    }
+
+    constexpr std::size_t page_size = 4096;
+    constexpr std::size_t line_size = 64;
+
+    // Storage for count objects of a given size, with logical index i living at slot(i). The same seed yields the same
+    // layout for the raw and floating versions so that both chase identical address sequences.
+    class node_storage {
+        std::vector<unsigned char> storage;
+        std::vector<std::size_t> offsets;
+    public:
+        node_storage(std::size_t count, std::size_t size, placement order, std::uint64_t seed) : offsets(count) {
+            bench::rng random(seed);
+            std::vector<std::size_t> slots(count);
+            for(std::size_t i = 0; i < count; i++) {
+                slots[i] = i;
+            }
+            if(order != placement::sequential) {
+                bench::shuffle(slots, random);
+            }
+            std::size_t stride = order == placement::scattered ? page_size : size;
+            storage.resize(count * stride + page_size);
+            std::size_t base = page_size - std::uintptr_t(storage.data()) % page_size;
+            for(std::size_t i = 0; i < count; i++) {
+                std::size_t offset = base + slots[i] * stride;
+                if(order == placement::scattered) {
+                    offset += random.below(page_size / line_size) * line_size;
+                }
+                offsets[i] = offset;
+            }
+        }
+        void* slot(std::size_t i) {
+            return storage.data() + offsets[i];
+        }
+    };
+
+    struct result {
+        double p50, p90, p99, max;
+        double llc_misses_per_op;
+    };
+
+    result summarize(std::vector<double>& samples, std::uint64_t misses, bool misses_valid, std::size_t ops) {
+        return {
+            bench::percentile(samples, 50),
+            bench::percentile(samples, 90),
+            bench::percentile(samples, 99),
+            bench::percentile(samples, 100),
+            misses_valid ? double(misses) / double(ops) : -1
+        };
+    }
+
+    void print_row(const char* workload, placement order, const char* pointer, const result& r) {
+        std::printf("%-14s %-11s %-9s %10.2f %10.2f %10.2f %10.2f %12s\n", workload, placement_name(order), pointer,
+                    r.p50, r.p90, r.p99, r.max, bench::format_events(r.llc_misses_per_op).c_str());
+    }
+
+    template<typename F>
+    result list_walk(std::size_t count, placement order, std::size_t segment) {
+        using node = list_node<F>;
+        node_storage storage(count, sizeof(node), order, count);
+        std::vector<node*> nodes(count);
+        for(std::size_t i = 0; i < count; i++) {
+            nodes[i] = new(storage.slot(i)) node{nullptr, i};
+        }
+        for(std::size_t i = 0; i < count; i++) {
+            nodes[i]->next = nodes[(i + 1) % count];
+        }
+        std::size_t segments = std::max<std::size_t>(64, 4 * count / segment);
+        std::vector<double> samples;
+        samples.reserve(segments);
+        auto misses = bench::llc_miss_counter();
+        typename F::template pointer<node> it = nodes[0];
+        std::uint64_t sum = 0;
+        // One untimed lap to fault in and warm what fits.
+        for(std::size_t i = 0; i < count; i++) {
+            sum += it->value;
+            it = it->next;
+        }
+        misses.start();
+        for(std::size_t s = 0; s < segments; s++) {
+            auto start = bench::clock::now();
+            for(std::size_t i = 0; i < segment; i++) {
+                sum += it->value;
+                it = it->next;
+            }
+            auto end = bench::clock::now();
+            samples.push_back(bench::elapsed_ns(start, end) / double(segment));
+        }
+        std::uint64_t missed = misses.stop();
+        bench::do_not_optimize(sum);
+        return summarize(samples, missed, misses.valid(), segments * segment);
+    }
+
+    template<typename F>
+    struct tree {
+        using node = tree_node<F>;
+        using pointer = typename F::template pointer<node>;
+        node_storage storage;
+        pointer root;
+        // A complete tree of count nodes in heap order: logical node i has children 2i+1 and 2i+2.
+        tree(std::size_t count, placement order) : storage(count, sizeof(node), order, count + 1) {
+            std::vector<node*> nodes(count);
+            for(std::size_t i = 0; i < count; i++) {
+                nodes[i] = new(storage.slot(i)) node{nullptr, nullptr, i};
+            }
+            for(std::size_t i = 0; i < count; i++) {
+                if(2 * i + 1 < count) {
+                    nodes[i]->left = nodes[2 * i + 1];
+                }
+                if(2 * i + 2 < count) {
+                    nodes[i]->right = nodes[2 * i + 2];
+                }
+            }
+            root = nodes[0];
+        }
+    };
+
+    template<typename P> void invert_tree(P root) {
+        if(root) {
+            std::swap(root->left, root->right);
+            invert_tree(root->left);
+            invert_tree(root->right);
+        }
+    }
+
+    template<typename F>
+    result tree_descend(tree<F>& t, std::size_t descents) {
+        std::vector<double> samples;
+        samples.reserve(descents);
+        bench::rng random(descents);
+        std::uint64_t sum = 0;
+        std::size_t visited = 0;
+        auto misses = bench::llc_miss_counter();
+        misses.start();
+        for(std::size_t d = 0; d < descents; d++) {
+            std::uint64_t path = random();
+            auto start = bench::clock::now();
+            auto it = t.root;
+            std::size_t level = 0;
+            for(; it; level++) {
+                sum += it->value;
+                it = (path >> (level & 63)) & 1 ? it->right : it->left;
+            }
+            auto end = bench::clock::now();
+            samples.push_back(bench::elapsed_ns(start, end) / double(level));
+            visited += level;
+        }
+        std::uint64_t missed = misses.stop();
+        bench::do_not_optimize(sum);
+        return summarize(samples, missed, misses.valid(), visited);
+    }
+
+    template<typename F>
+    result tree_invert(tree<F>& t, std::size_t count, std::size_t passes) {
+        std::vector<double> samples;
+        samples.reserve(passes);
+        auto misses = bench::llc_miss_counter();
+        misses.start();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            auto start = bench::clock::now();
+            invert_tree(t.root);
+            auto end = bench::clock::now();
+            samples.push_back(bench::elapsed_ns(start, end) / double(count));
+        }
+        std::uint64_t missed = misses.stop();
+        return summarize(samples, missed, misses.valid(), passes * count);
+    }
+
+    template<typename F>
+    void run_lists(std::size_t count, placement order, std::size_t segment) {
+        print_row("list walk", order, F::name, list_walk<F>(count, order, segment));
+    }
+
+    template<typename F>
+    void run_trees(std::size_t count, placement order) {
+        tree<F> t(count, order);
+        print_row("tree descend", order, F::name, tree_descend(t, std::max<std::size_t>(4096, count / 8)));
+        print_row("invert_tree", order, F::name, tree_invert(t, count, 9));
+    }
+}
+
+int main() {
+    std::size_t nodes = bench::env_size("BENCH_NODES", std::size_t(1) << 21);
+    std::size_t scatter_nodes = std::min(nodes, bench::env_size("BENCH_SCATTER_NODES", std::size_t(1) << 16));
+    std::size_t segment = bench::env_size("BENCH_SEGMENT", 1024);
+    if(!bench::llc_miss_counter().valid()) {
+        std::printf("note: perf_event_open unavailable, LLC miss counts disabled\n");
+    }
+    std::printf("latencies are ns per hop (per visited node for invert_tree)\n");
+    std::printf("%-14s %-11s %-9s %10s %10s %10s %10s %12s\n", "workload", "placement", "pointer", "p50", "p90", "p99",
+                "max", "LLC miss/op");
+    for(placement order : {placement::sequential, placement::shuffled, placement::scattered}) {
+        std::size_t count = order == placement::scattered ? scatter_nodes : nodes;
+        run_lists<raw_pointers>(count, order, segment);
+        run_lists<floating_pointers>(count, order, segment);
+    }
+    for(placement order : {placement::sequential, placement::shuffled, placement::scattered}) {
+        std::size_t count = order == placement::scattered ? scatter_nodes : nodes;
+        run_trees<raw_pointers>(count, order);
+        run_trees<floating_pointers>(count, order);
+    }
+}
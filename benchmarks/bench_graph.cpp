@@ -0,0 +1,167 @@
+// Benchmark: breadth first search and PageRank on synthetic RMAT graphs (Graph500 parameters a = 0.57, b = c = 0.19,
+// 16 edges per vertex, vertex ids permuted, made symmetric). floating_csr_graph with floating_bfs and floating_pagerank
+// against the same graph as heap-allocated nodes holding a std::vector<node*> of neighbors each, searched with a
+// serial queue and ranked by a serial pull loop. Reported: ms per search (the mean over several sources) or per
+// PageRank iteration, millions of edges per second over all of the graph's directed edges, and LLC misses per edge.
+//
+// Environment: BENCH_SCALE_MIN and BENCH_SCALE (log2 of the smallest and largest vertex count, default 16 and 18; set
+// BENCH_SCALE to 26 for the full run, which needs tens of GB), BENCH_THREADS (threads for the parallel kernels,
+// default hardware concurrency), BENCH_SOURCES (searches per measurement, default 4).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <floating_csr_graph.hpp>
+
+#include "bench.hpp"
+
+using based::floating_csr_graph;
+
+namespace {
+    using vertex = std::uint32_t;
+
+    struct node {
+        std::vector<node*> neighbors;
+        vertex id;
+    };
+
+    std::vector<std::pair<vertex, vertex>> rmat_edges(unsigned scale, bench::rng& random) {
+        std::size_t n = std::size_t(1) << scale;
+        std::vector<vertex> label(n);
+        for(std::size_t v = 0; v < n; v++) {
+            label[v] = vertex(v);
+        }
+        bench::shuffle(label, random);
+        std::vector<std::pair<vertex, vertex>> edges;
+        edges.reserve(2 * 16 * n);
+        for(std::size_t i = 0; i < 16 * n; i++) {
+            std::size_t from = 0;
+            std::size_t to = 0;
+            for(unsigned bit = 0; bit < scale; bit++) {
+                // Quadrants with probability a = 57%, b = 19%, c = 19%, d = 5%
+                std::uint64_t r = random.below(100);
+                from = 2 * from + (r >= 76);
+                to = 2 * to + (r >= 57 && r < 76) + (r >= 95);
+            }
+            if(from != to) {
+                edges.emplace_back(label[from], label[to]);
+                edges.emplace_back(label[to], label[from]);
+            }
+        }
+        return edges;
+    }
+
+    void print(const char* kernel, const char* layout, unsigned threads, std::size_t edges,
+               const bench::measurement& m) {
+        std::printf("%-9s %-22s %7u %10.2f %10.1f %10s\n", kernel, layout, threads, m.ns_per_op * double(edges) / 1e6,
+                    1e3 / m.ns_per_op, bench::format_events(m.events_per_op).c_str());
+    }
+
+    void run(unsigned scale, unsigned threads, std::size_t source_count) {
+        bench::rng random(scale);
+        std::size_t n = std::size_t(1) << scale;
+        auto edges = rmat_edges(scale, random);
+        floating_csr_graph<vertex> graph(n, edges);
+        // The node graph with nodes allocated in random order, as a long-lived heap leaves them
+        std::vector<vertex> order(n);
+        for(std::size_t v = 0; v < n; v++) {
+            order[v] = vertex(v);
+        }
+        bench::shuffle(order, random);
+        std::vector<std::unique_ptr<node>> nodes(n);
+        for(vertex v : order) {
+            nodes[v].reset(new node{{}, v});
+        }
+        for(const auto& e : edges) {
+            nodes[e.first]->neighbors.push_back(nodes[e.second].get());
+        }
+        std::vector<std::pair<vertex, vertex>>().swap(edges);
+        std::vector<vertex> sources;
+        while(sources.size() < source_count) {
+            vertex s = vertex(random.below(n));
+            if(graph.degree(s)) {
+                sources.push_back(s);
+            }
+        }
+        std::size_t m = graph.edge_count();
+        std::printf("scale %u: %zu vertices, %zu directed edges\n", scale, n, m);
+
+        auto llc = bench::llc_miss_counter();
+        print("bfs", "vector<node*>", 1, m, bench::measure(m * sources.size(), llc, [&] {
+            std::vector<vertex> parent(n, floating_csr_graph<vertex>::no_vertex);
+            std::vector<node*> queue;
+            queue.reserve(n);
+            for(vertex s : sources) {
+                std::fill(parent.begin(), parent.end(), floating_csr_graph<vertex>::no_vertex);
+                queue.assign(1, nodes[s].get());
+                parent[s] = s;
+                for(std::size_t head = 0; head < queue.size(); head++) {
+                    node* u = queue[head];
+                    for(node* w : u->neighbors) {
+                        if(parent[w->id] == floating_csr_graph<vertex>::no_vertex) {
+                            parent[w->id] = u->id;
+                            queue.push_back(w);
+                        }
+                    }
+                }
+                bench::do_not_optimize(parent[0]);
+            }
+        }, 3));
+        for(unsigned t : {1u, threads}) {
+            print("bfs", "floating_csr_graph", t, m, bench::measure(m * sources.size(), llc, [&] {
+                for(vertex s : sources) {
+                    auto parent = based::floating_bfs(graph, s, t);
+                    bench::do_not_optimize(parent[0]);
+                }
+            }, 3));
+            if(t == threads) {
+                break;
+            }
+        }
+
+        constexpr std::size_t iterations = 5;
+        print("pagerank", "vector<node*>", 1, m, bench::measure(m * iterations, llc, [&] {
+            std::vector<double> rank(n, 1.0 / double(n));
+            std::vector<double> contribution(n);
+            for(std::size_t i = 0; i < iterations; i++) {
+                for(std::size_t v = 0; v < n; v++) {
+                    std::size_t degree = nodes[v]->neighbors.size();
+                    contribution[v] = degree ? rank[v] / double(degree) : 0.0;
+                }
+                for(std::size_t v = 0; v < n; v++) {
+                    double sum = 0;
+                    for(node* u : nodes[v]->neighbors) {
+                        sum += contribution[u->id];
+                    }
+                    rank[v] = 0.15 / double(n) + 0.85 * sum;
+                }
+            }
+            bench::do_not_optimize(rank[0]);
+        }, 3));
+        for(unsigned t : {1u, threads}) {
+            print("pagerank", "floating_csr_graph", t, m, bench::measure(m * iterations, llc, [&] {
+                auto rank = based::floating_pagerank(graph, iterations, 0.85, t);
+                bench::do_not_optimize(rank[0]);
+            }, 3));
+            if(t == threads) {
+                break;
+            }
+        }
+    }
+}
+
+int main() {
+    unsigned min_scale = unsigned(bench::env_size("BENCH_SCALE_MIN", 16));
+    unsigned max_scale = unsigned(bench::env_size("BENCH_SCALE", 18));
+    unsigned threads = unsigned(bench::env_size("BENCH_THREADS", std::max(1u, std::thread::hardware_concurrency())));
+    std::size_t sources = std::max<std::size_t>(1, bench::env_size("BENCH_SOURCES", 4));
+    std::printf("%-9s %-22s %7s %10s %10s %10s\n", "kernel", "layout", "threads", "ms", "Medges/s", "LLC/edge");
+    for(unsigned scale = min_scale; scale <= max_scale; scale += 2) {
+        run(scale, threads, sources);
+    }
+}
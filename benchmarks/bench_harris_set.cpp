@@ -0,0 +1,122 @@
+// Benchmark: a concurrent ordered set under a read-mostly mix (90% contains, 5% insert, 5% erase over a small key
+// range) with floating_harris_set against std::set behind a std::mutex and behind a std::shared_mutex. Reported
+// numbers are millions of operations per second across all threads.
+//
+// Environment: BENCH_THREADS (maximum thread count, default 2 * hardware concurrency), BENCH_OPS (operations per
+// thread, default 1<<20), BENCH_KEYS (key range, default 512).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <floating_harris_set.hpp>
+
+#include "bench.hpp"
+
+using based::floating_harris_set;
+
+namespace {
+    struct mutex_set {
+        static constexpr const char* name = "mutex std::set";
+        std::mutex lock;
+        std::set<std::uint64_t> set;
+        bool insert(std::uint64_t k) {
+            std::lock_guard<std::mutex> guard(lock);
+            return set.insert(k).second;
+        }
+        bool erase(std::uint64_t k) {
+            std::lock_guard<std::mutex> guard(lock);
+            return set.erase(k);
+        }
+        bool contains(std::uint64_t k) {
+            std::lock_guard<std::mutex> guard(lock);
+            return set.count(k);
+        }
+    };
+
+    struct shared_mutex_set {
+        static constexpr const char* name = "shared_mutex std::set";
+        std::shared_mutex lock;
+        std::set<std::uint64_t> set;
+        bool insert(std::uint64_t k) {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            return set.insert(k).second;
+        }
+        bool erase(std::uint64_t k) {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            return set.erase(k);
+        }
+        bool contains(std::uint64_t k) {
+            std::shared_lock<std::shared_mutex> guard(lock);
+            return set.count(k);
+        }
+    };
+
+    struct harris_set : floating_harris_set<std::uint64_t> {
+        static constexpr const char* name = "floating_harris_set";
+    };
+
+    template<typename Set>
+    double run(std::size_t threads, std::size_t ops, std::size_t keys) {
+        double best = 0;
+        for(int repetition = 0; repetition < 3; repetition++) {
+            Set set;
+            for(std::uint64_t k = 0; k < keys; k += 2) {
+                set.insert(k);
+            }
+            std::atomic<std::size_t> ready{0};
+            std::atomic<bool> go{false};
+            std::vector<std::thread> pool;
+            for(std::size_t t = 0; t < threads; t++) {
+                pool.emplace_back([&, t] {
+                    bench::rng random(t + 1);
+                    ready++;
+                    while(!go.load(std::memory_order_acquire)) {}
+                    std::size_t found = 0;
+                    for(std::size_t i = 0; i < ops; i++) {
+                        std::uint64_t k = random.below(keys);
+                        std::uint64_t roll = random.below(100);
+                        if(roll < 5) {
+                            set.insert(k);
+                        } else if(roll < 10) {
+                            set.erase(k);
+                        } else {
+                            found += set.contains(k);
+                        }
+                    }
+                    bench::do_not_optimize(found);
+                });
+            }
+            while(ready.load() != threads) {}
+            auto start = bench::clock::now();
+            go.store(true, std::memory_order_release);
+            for(auto& thread : pool) {
+                thread.join();
+            }
+            auto end = bench::clock::now();
+            best = std::max(best, double(threads * ops) / bench::elapsed_ns(start, end) * 1e3);
+        }
+        return best;
+    }
+}
+
+int main() {
+    std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t max_threads = bench::env_size("BENCH_THREADS", 2 * hardware);
+    std::size_t ops = bench::env_size("BENCH_OPS", std::size_t(1) << 20);
+    std::size_t keys = bench::env_size("BENCH_KEYS", 512);
+    std::printf("millions of operations per second, %zu operations per thread, %zu keys\n", ops, keys);
+    std::printf("%8s %22s %22s %22s\n", "threads", mutex_set::name, shared_mutex_set::name, harris_set::name);
+    for(std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double m = run<mutex_set>(threads, ops, keys);
+        double s = run<shared_mutex_set>(threads, ops, keys);
+        double h = run<harris_set>(threads, ops, keys);
+        std::printf("%8zu %22.2f %22.2f %22.2f\n", threads, m, s, h);
+    }
+}
@@ -0,0 +1,106 @@
+// Benchmark: multi-threaded small object allocation with floating_heap against glibc malloc.
+//
+// Every thread repeatedly allocates a window of objects with sizes drawn from 16 to 256 bytes, touches them, and frees
+// them in shuffled order. Reported numbers are millions of alloc/free pairs per second across all threads.
+//
+// Environment: BENCH_THREADS (maximum thread count, default 2 * hardware concurrency), BENCH_PAIRS (alloc/free pairs
+// per thread, default 1<<22), BENCH_WINDOW (live objects per thread, default 1024).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <floating_heap.hpp>
+
+#include "bench.hpp"
+
+using based::floating_heap;
+
+namespace {
+    struct malloc_policy {
+        static constexpr const char* name = "malloc";
+        static void* allocate(std::size_t bytes) {
+            return std::malloc(bytes);
+        }
+        static void deallocate(void* p, std::size_t) {
+            std::free(p);
+        }
+    };
+
+    struct floating_heap_policy {
+        static constexpr const char* name = "floating_heap";
+        static void* allocate(std::size_t bytes) {
+            return floating_heap::instance().allocate(bytes, alignof(std::max_align_t));
+        }
+        static void deallocate(void* p, std::size_t bytes) {
+            floating_heap::instance().deallocate(p, bytes, alignof(std::max_align_t));
+        }
+    };
+
+    template<typename Policy>
+    void worker(std::size_t pairs, std::size_t window, std::uint64_t seed) {
+        bench::rng random(seed);
+        std::vector<std::size_t> sizes(window);
+        std::vector<std::size_t> order(window);
+        std::vector<void*> objects(window);
+        for(std::size_t i = 0; i < window; i++) {
+            sizes[i] = 16 + random.below(241);
+            order[i] = i;
+        }
+        bench::shuffle(order, random);
+        for(std::size_t done = 0; done < pairs; done += window) {
+            for(std::size_t i = 0; i < window; i++) {
+                objects[i] = Policy::allocate(sizes[i]);
+                *static_cast<unsigned char*>(objects[i]) = static_cast<unsigned char>(i);
+            }
+            for(std::size_t i : order) {
+                Policy::deallocate(objects[i], sizes[i]);
+            }
+        }
+    }
+
+    template<typename Policy>
+    double run(std::size_t threads, std::size_t pairs, std::size_t window) {
+        double best = 0;
+        for(int repetition = 0; repetition < 3; repetition++) {
+            std::atomic<std::size_t> ready{0};
+            std::atomic<bool> go{false};
+            std::vector<std::thread> pool;
+            for(std::size_t t = 0; t < threads; t++) {
+                pool.emplace_back([&, t] {
+                    ready++;
+                    while(!go.load(std::memory_order_acquire)) {}
+                    worker<Policy>(pairs, window, t + 1);
+                });
+            }
+            while(ready.load() != threads) {}
+            auto start = bench::clock::now();
+            go.store(true, std::memory_order_release);
+            for(auto& thread : pool) {
+                thread.join();
+            }
+            auto end = bench::clock::now();
+            best = std::max(best, double(threads * pairs) / bench::elapsed_ns(start, end) * 1e3);
+        }
+        return best;
+    }
+}
+
+int main() {
+    std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t max_threads = bench::env_size("BENCH_THREADS", 2 * hardware);
+    std::size_t pairs = bench::env_size("BENCH_PAIRS", std::size_t(1) << 22);
+    std::size_t window = bench::env_size("BENCH_WINDOW", 1024);
+    std::printf("millions of alloc/free pairs per second, %zu pairs per thread, %zu live objects per thread\n", pairs,
+                window);
+    std::printf("%8s %14s %14s\n", "threads", malloc_policy::name, floating_heap_policy::name);
+    for(std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double m = run<malloc_policy>(threads, pairs, window);
+        double f = run<floating_heap_policy>(threads, pairs, window);
+        std::printf("%8zu %14.2f %14.2f\n", threads, m, f);
+    }
+}
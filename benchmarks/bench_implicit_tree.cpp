@@ -0,0 +1,116 @@
+// Benchmark: read-only lookups in a binary search tree of floating_pointer nodes against floating_implicit_tree copies
+// of it in Eytzinger and van Emde Boas layout, and std::lower_bound over a sorted array. The pointer tree is built by
+// random insertion, so nodes are scattered through the heap. Lookups are uniformly random present keys. Reported: ns
+// and LLC misses per lookup.
+//
+// Environment: BENCH_KEYS (largest key count, default 1<<22; counts grow by 16x from 1<<10), BENCH_LOOKUPS (default
+// 1<<20).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <floating_implicit_tree.hpp>
+
+#include "bench.hpp"
+
+using based::floating_implicit_tree;
+using based::floating_pointer;
+using based::implicit_layout;
+
+namespace {
+    struct node {
+        floating_pointer<node> left;
+        floating_pointer<node> right;
+        std::uint64_t key;
+        std::uint64_t value;
+    };
+
+    template<typename F>
+    void report(const char* name, std::size_t n, std::size_t lookups, F&& find) {
+        auto llc = bench::llc_miss_counter();
+        auto m = bench::measure(lookups, llc, find, 3);
+        std::printf("%-22s %10zu %10.1f %10s\n", name, n, m.ns_per_op, bench::format_events(m.events_per_op).c_str());
+    }
+
+    void run(std::size_t n, std::size_t lookup_count) {
+        bench::rng random(n);
+        std::vector<std::uint64_t> keys(n);
+        for(std::size_t i = 0; i < n; i++) {
+            keys[i] = 3 * i + 1;
+        }
+        bench::shuffle(keys, random);
+        std::vector<std::unique_ptr<node>> nodes;
+        floating_pointer<node> root = nullptr;
+        for(std::uint64_t k : keys) {
+            nodes.emplace_back(new node{nullptr, nullptr, k, k ^ 0x5555});
+            floating_pointer<node>* link = &root;
+            while(*link) {
+                link = k < (*link)->key ? &(*link)->left : &(*link)->right;
+            }
+            *link = nodes.back().get();
+        }
+        std::vector<std::uint64_t> lookups(lookup_count);
+        for(auto& k : lookups) {
+            k = keys[random.below(n)];
+        }
+        auto key = [](const node& x) { return x.key; };
+        auto value = [](const node& x) { return x.value; };
+        auto eytzinger = floating_implicit_tree<std::uint64_t, std::uint64_t>::from_tree(root, key, value,
+                                                                                         implicit_layout::eytzinger);
+        auto veb = floating_implicit_tree<std::uint64_t, std::uint64_t>::from_tree(root, key, value,
+                                                                                   implicit_layout::van_emde_boas);
+        std::vector<std::uint64_t> sorted_keys = keys;
+        std::sort(sorted_keys.begin(), sorted_keys.end());
+        std::vector<std::uint64_t> sorted_values(n);
+        for(std::size_t i = 0; i < n; i++) {
+            sorted_values[i] = sorted_keys[i] ^ 0x5555;
+        }
+
+        report("floating_pointer tree", n, lookup_count, [&] {
+            std::uint64_t sum = 0;
+            for(std::uint64_t k : lookups) {
+                floating_pointer<node> p = root;
+                while(p->key != k) {
+                    p = k < p->key ? p->left : p->right;
+                }
+                sum += p->value;
+            }
+            bench::do_not_optimize(sum);
+        });
+        report("std::lower_bound", n, lookup_count, [&] {
+            std::uint64_t sum = 0;
+            for(std::uint64_t k : lookups) {
+                auto it = std::lower_bound(sorted_keys.begin(), sorted_keys.end(), k);
+                sum += sorted_values[std::size_t(it - sorted_keys.begin())];
+            }
+            bench::do_not_optimize(sum);
+        });
+        report("eytzinger", n, lookup_count, [&] {
+            std::uint64_t sum = 0;
+            for(std::uint64_t k : lookups) {
+                sum += *eytzinger.find(k);
+            }
+            bench::do_not_optimize(sum);
+        });
+        report("van emde boas", n, lookup_count, [&] {
+            std::uint64_t sum = 0;
+            for(std::uint64_t k : lookups) {
+                sum += *veb.find(k);
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+int main() {
+    std::size_t max_keys = bench::env_size("BENCH_KEYS", std::size_t(1) << 22);
+    std::size_t lookups = bench::env_size("BENCH_LOOKUPS", std::size_t(1) << 20);
+    std::printf("%-22s %10s %10s %10s\n", "layout", "keys", "ns/lookup", "LLC/lookup");
+    for(std::size_t n = std::size_t(1) << 10; n <= max_keys; n *= 16) {
+        run(n, lookups);
+    }
+}
@@ -0,0 +1,153 @@
+// Benchmark: contended MPMC work queues and stacks. Every thread repeatedly pushes an item and pops one, so all threads
+// hammer the same head and tail. floating_ms_queue and floating_treiber_stack are compared against a std::queue or
+// std::vector behind a std::mutex and, when Boost was found at configure time, boost::lockfree::queue and stack.
+// Reported numbers are millions of push/pop pairs per second across all threads.
+//
+// Environment: BENCH_THREADS (maximum thread count, default 64), BENCH_PAIRS (push/pop pairs per thread, default
+// 1<<18).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <floating_ms_queue.hpp>
+#include <floating_treiber_stack.hpp>
+
+#ifdef BENCH_HAVE_BOOST_LOCKFREE
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/stack.hpp>
+#endif
+
+#include "bench.hpp"
+
+using based::floating_ms_queue;
+using based::floating_treiber_stack;
+
+namespace {
+    constexpr std::size_t pool_size = 4096;
+
+    struct mutex_queue {
+        std::mutex lock;
+        std::queue<std::uint64_t> queue;
+        bool push(std::uint64_t v) {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push(v);
+            return true;
+        }
+        bool pop(std::uint64_t& v) {
+            std::lock_guard<std::mutex> guard(lock);
+            if(queue.empty()) {
+                return false;
+            }
+            v = queue.front();
+            queue.pop();
+            return true;
+        }
+    };
+
+    struct mutex_stack {
+        std::mutex lock;
+        std::vector<std::uint64_t> stack;
+        bool push(std::uint64_t v) {
+            std::lock_guard<std::mutex> guard(lock);
+            stack.push_back(v);
+            return true;
+        }
+        bool pop(std::uint64_t& v) {
+            std::lock_guard<std::mutex> guard(lock);
+            if(stack.empty()) {
+                return false;
+            }
+            v = stack.back();
+            stack.pop_back();
+            return true;
+        }
+    };
+
+    struct ms_queue : floating_ms_queue<std::uint64_t> {
+        ms_queue() : floating_ms_queue(pool_size) {}
+    };
+    struct treiber_stack : floating_treiber_stack<std::uint64_t> {
+        treiber_stack() : floating_treiber_stack(pool_size) {}
+    };
+
+    #ifdef BENCH_HAVE_BOOST_LOCKFREE
+    struct boost_queue : boost::lockfree::queue<std::uint64_t> {
+        boost_queue() : boost::lockfree::queue<std::uint64_t>(pool_size) {}
+        bool push(std::uint64_t v) {
+            return bounded_push(v);
+        }
+    };
+    struct boost_stack : boost::lockfree::stack<std::uint64_t> {
+        boost_stack() : boost::lockfree::stack<std::uint64_t>(pool_size) {}
+        bool push(std::uint64_t v) {
+            return bounded_push(v);
+        }
+    };
+    #endif
+
+    template<typename Container>
+    double run(std::size_t threads, std::size_t pairs) {
+        double best = 0;
+        for(int repetition = 0; repetition < 3; repetition++) {
+            Container container;
+            std::atomic<std::size_t> ready{0};
+            std::atomic<bool> go{false};
+            std::vector<std::thread> pool;
+            for(std::size_t t = 0; t < threads; t++) {
+                pool.emplace_back([&, t] {
+                    ready++;
+                    while(!go.load(std::memory_order_acquire)) {}
+                    std::uint64_t sum = 0;
+                    for(std::size_t i = 0; i < pairs; i++) {
+                        while(!container.push(t * pairs + i)) {
+                            std::this_thread::yield();
+                        }
+                        std::uint64_t v;
+                        // Another thread may have taken every item; one will show up once it pushes again
+                        while(!container.pop(v)) {
+                            std::this_thread::yield();
+                        }
+                        sum += v;
+                    }
+                    bench::do_not_optimize(sum);
+                });
+            }
+            while(ready.load() != threads) {}
+            auto start = bench::clock::now();
+            go.store(true, std::memory_order_release);
+            for(auto& thread : pool) {
+                thread.join();
+            }
+            auto end = bench::clock::now();
+            best = std::max(best, double(threads * pairs) / bench::elapsed_ns(start, end) * 1e3);
+        }
+        return best;
+    }
+}
+
+int main() {
+    std::size_t max_threads = bench::env_size("BENCH_THREADS", 64);
+    std::size_t pairs = bench::env_size("BENCH_PAIRS", std::size_t(1) << 18);
+    std::printf("millions of push/pop pairs per second, %zu pairs per thread\n", pairs);
+    std::printf("%8s %14s %14s %14s %14s %14s %14s\n", "threads", "mutex queue", "boost queue", "ms_queue",
+                "mutex stack", "boost stack", "treiber_stack");
+    for(std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double mq = run<mutex_queue>(threads, pairs);
+        double fq = run<ms_queue>(threads, pairs);
+        double ms = run<mutex_stack>(threads, pairs);
+        double fs = run<treiber_stack>(threads, pairs);
+        #ifdef BENCH_HAVE_BOOST_LOCKFREE
+        double bq = run<boost_queue>(threads, pairs);
+        double bs = run<boost_stack>(threads, pairs);
+        std::printf("%8zu %14.2f %14.2f %14.2f %14.2f %14.2f %14.2f\n", threads, mq, bq, fq, ms, bs, fs);
+        #else
+        std::printf("%8zu %14.2f %14s %14.2f %14.2f %14s %14.2f\n", threads, mq, "n/a", fq, ms, "n/a", fs);
+        #endif
+    }
+}
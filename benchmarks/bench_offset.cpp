@@ -0,0 +1,116 @@
+// Benchmark: adjacency lists whose edges are raw pointers, floating pointers, or compact base-relative floating
+// offsets. Each run sums, for every vertex, the values of its neighbors; the table shows the bytes spent on edges and
+// the time per edge. _Float16 offsets only address 2048 vertices and are skipped for larger graphs.
+//
+// Environment: BENCH_VERTICES (vertices in the large graph, default 1<<20), BENCH_DEGREE (edges per vertex, default
+// 16).
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <floating_offset.hpp>
+
+#include "bench.hpp"
+
+using based::floating_offset;
+using based::floating_pointer;
+
+namespace {
+    struct vertex {
+        std::uint32_t value;
+    };
+
+    struct graph {
+        std::vector<vertex> vertices;
+        std::vector<std::uint32_t> first; // CSR row starts, one past the end for the last vertex
+        std::vector<std::uint32_t> targets;
+        graph(std::size_t count, std::size_t degree) : vertices(count), first(count + 1) {
+            bench::rng random(count);
+            for(std::size_t v = 0; v < count; v++) {
+                vertices[v].value = std::uint32_t(random());
+                first[v] = std::uint32_t(targets.size());
+                for(std::size_t e = 0; e < degree; e++) {
+                    targets.push_back(std::uint32_t(random.below(count)));
+                }
+            }
+            first[count] = std::uint32_t(targets.size());
+        }
+    };
+
+    vertex& target(vertex*, vertex* edge) {
+        return *edge;
+    }
+    vertex& target(vertex*, floating_pointer<vertex> edge) {
+        return *edge;
+    }
+    template<typename Repr> vertex& target(vertex* base, floating_offset<vertex, Repr> edge) {
+        return base[edge.index()];
+    }
+
+    template<typename Edge>
+    void run(const char* name, graph& g, std::vector<Edge> (*make_edges)(graph&)) {
+        std::vector<Edge> edges = make_edges(g);
+        std::vector<std::uint32_t> sums(g.vertices.size());
+        vertex* base = g.vertices.data();
+        auto counter = bench::instruction_counter();
+        auto m = bench::measure(edges.size(), counter, [&] {
+            for(std::size_t v = 0; v + 1 < g.first.size(); v++) {
+                std::uint32_t sum = 0;
+                for(std::uint32_t e = g.first[v]; e < g.first[v + 1]; e++) {
+                    sum += target(base, edges[e]).value;
+                }
+                sums[v] = sum;
+            }
+            bench::clobber();
+        }, 5);
+        std::size_t edge_bytes = edges.size() * sizeof(Edge);
+        std::size_t working_set = edge_bytes + g.vertices.size() * sizeof(vertex)
+                                  + g.first.size() * sizeof(std::uint32_t);
+        std::printf("%-26s %8zu %14.1f %14.1f %12.3f\n", name, sizeof(Edge), double(edge_bytes) / (1 << 20),
+                    double(working_set) / (1 << 20), m.ns_per_op);
+    }
+
+    std::vector<vertex*> raw_edges(graph& g) {
+        std::vector<vertex*> edges;
+        for(auto t : g.targets) {
+            edges.push_back(&g.vertices[t]);
+        }
+        return edges;
+    }
+    std::vector<floating_pointer<vertex>> floating_edges(graph& g) {
+        std::vector<floating_pointer<vertex>> edges;
+        for(auto t : g.targets) {
+            edges.push_back(&g.vertices[t]);
+        }
+        return edges;
+    }
+    template<typename Repr> std::vector<floating_offset<vertex, Repr>> offset_edges(graph& g) {
+        std::vector<floating_offset<vertex, Repr>> edges;
+        for(auto t : g.targets) {
+            edges.push_back(floating_offset<vertex, Repr>(std::size_t(t)));
+        }
+        return edges;
+    }
+
+    void run_graph(std::size_t count, std::size_t degree) {
+        graph g(count, degree);
+        std::printf("\n%zu vertices, %zu edges\n", count, g.targets.size());
+        std::printf("%-26s %8s %14s %14s %12s\n", "edge type", "bytes", "edges MiB", "working MiB", "ns/edge");
+        run<vertex*>("vertex*", g, raw_edges);
+        run<floating_pointer<vertex>>("floating_pointer", g, floating_edges);
+        run<floating_offset<vertex, float>>("floating_offset<float>", g, offset_edges<float>);
+        #ifdef __FLT16_MANT_DIG__
+        if(count <= floating_offset<vertex, _Float16>::max_elements) {
+            run<floating_offset<vertex, _Float16>>("floating_offset<_Float16>", g, offset_edges<_Float16>);
+        }
+        #endif
+    }
+}
+
+int main() {
+    std::size_t count = bench::env_size("BENCH_VERTICES", std::size_t(1) << 20);
+    std::size_t degree = bench::env_size("BENCH_DEGREE", 16);
+    run_graph(2048, degree);
+    run_graph(count, degree);
+}
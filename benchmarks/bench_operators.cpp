@@ -0,0 +1,269 @@
+// Microbenchmark: every floating_pointer<T> operator against the same code written with a raw T*.
+//
+// For each sizeof(T) the working set is kept L1-resident so that the numbers show the cost of the double <-> integer
+// conversions rather than the memory system. Instructions per operation come from the hardware instruction counter
+// and are reported as n/a when perf_event_open is unavailable.
+//
+// Environment: BENCH_OPS (operations per repetition, default 1<<20).
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <floating_pointers.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+
+namespace {
+    template<std::size_t N> struct element {
+        std::uint8_t bytes[N];
+    };
+
+    // Raw pointer spellings of the floating pointer math functions: round trip through the same double arithmetic.
+    template<typename T> T* pointer_sqrt(T* p) {
+        return (T*)std::uintptr_t(std::sqrt(double(std::uintptr_t(p))));
+    }
+    template<typename T> T* pointer_fma(T* p, double y, std::ptrdiff_t z) {
+        return (T*)std::uintptr_t(double(std::uintptr_t(p)) * y) + z;
+    }
+    template<typename T> T* pointer_fmod(T* p, double v) {
+        return (T*)std::uintptr_t(std::fmod(double(std::uintptr_t(p)), v));
+    }
+    template<typename T> floating_pointer<T> pointer_sqrt(floating_pointer<T> p) {
+        return sqrt(p);
+    }
+    template<typename T> floating_pointer<T> pointer_fma(floating_pointer<T> p, double y, std::ptrdiff_t z) {
+        return fma(p, y, z);
+    }
+    template<typename T> floating_pointer<T> pointer_fmod(floating_pointer<T> p, double v) {
+        return fmod(p, v);
+    }
+
+    template<typename P, typename E>
+    struct fixture {
+        std::vector<E>& data;
+        std::vector<P> pointers;
+        std::vector<std::size_t> indices;
+        P base;
+        fixture(std::vector<E>& data, const std::vector<std::size_t>& order) : data(data), indices(order) {
+            base = P(data.data());
+            for(std::size_t i : order) {
+                pointers.push_back(P(&data[i]));
+            }
+        }
+    };
+
+    template<typename P, typename E> void op_deref(fixture<P, E>& f, std::size_t passes) {
+        unsigned sum = 0;
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(const P& p : f.pointers) {
+                sum += (*p).bytes[0];
+            }
+        }
+        bench::do_not_optimize(sum);
+    }
+    template<typename P, typename E> void op_arrow(fixture<P, E>& f, std::size_t passes) {
+        unsigned sum = 0;
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(const P& p : f.pointers) {
+                sum += p->bytes[0];
+            }
+        }
+        bench::do_not_optimize(sum);
+    }
+    template<typename P, typename E> void op_subscript(fixture<P, E>& f, std::size_t passes) {
+        unsigned sum = 0;
+        P base = f.base;
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(std::size_t i : f.indices) {
+                sum += base[i].bytes[0];
+            }
+        }
+        bench::do_not_optimize(sum);
+    }
+    template<typename P, typename E> void op_increment(fixture<P, E>& f, std::size_t passes) {
+        std::size_t n = f.pointers.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            P it = f.base;
+            for(std::size_t i = 0; i < n; i++) {
+                ++it;
+                bench::do_not_optimize(it);
+            }
+        }
+    }
+    template<typename P, typename E> void op_post_increment(fixture<P, E>& f, std::size_t passes) {
+        std::size_t n = f.pointers.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            P it = f.base;
+            for(std::size_t i = 0; i < n; i++) {
+                bench::do_not_optimize(it++);
+            }
+        }
+    }
+    template<typename P, typename E> void op_decrement(fixture<P, E>& f, std::size_t passes) {
+        std::size_t n = f.pointers.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            P it = f.base + n;
+            for(std::size_t i = 0; i < n; i++) {
+                --it;
+                bench::do_not_optimize(it);
+            }
+        }
+    }
+    template<typename P, typename E> void op_plus_assign(fixture<P, E>& f, std::size_t passes) {
+        std::size_t n = f.pointers.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            P it = f.base;
+            for(std::size_t i = 0; i < n; i++) {
+                it += (i & 1);
+                bench::do_not_optimize(it);
+            }
+        }
+    }
+    template<typename P, typename E> void op_plus(fixture<P, E>& f, std::size_t passes) {
+        P base = f.base;
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(std::size_t i : f.indices) {
+                bench::do_not_optimize(base + i);
+            }
+        }
+    }
+    template<typename P, typename E> void op_minus(fixture<P, E>& f, std::size_t passes) {
+        P end = f.base + f.indices.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(std::size_t i : f.indices) {
+                bench::do_not_optimize(end - i);
+            }
+        }
+    }
+    template<typename P, typename E> void op_equal(fixture<P, E>& f, std::size_t passes) {
+        std::size_t count = 0, n = f.pointers.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(std::size_t i = 1; i < n; i++) {
+                count += f.pointers[i - 1] == f.pointers[i];
+            }
+            count += f.pointers[n - 1] == f.pointers[0];
+        }
+        bench::do_not_optimize(count);
+    }
+    template<typename P, typename E> void op_less(fixture<P, E>& f, std::size_t passes) {
+        std::size_t count = 0, n = f.pointers.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(std::size_t i = 1; i < n; i++) {
+                count += f.pointers[i - 1] < f.pointers[i];
+            }
+            count += f.pointers[n - 1] < f.pointers[0];
+        }
+        bench::do_not_optimize(count);
+    }
+    template<typename P, typename E> void op_sqrt(fixture<P, E>& f, std::size_t passes) {
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(const P& p : f.pointers) {
+                bench::do_not_optimize(pointer_sqrt(p));
+            }
+        }
+    }
+    template<typename P, typename E> void op_fma(fixture<P, E>& f, std::size_t passes) {
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(const P& p : f.pointers) {
+                bench::do_not_optimize(pointer_fma(p, 1.0, 3));
+            }
+        }
+    }
+    template<typename P, typename E> void op_fmod(fixture<P, E>& f, std::size_t passes) {
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(const P& p : f.pointers) {
+                bench::do_not_optimize(pointer_fmod(p, 4096.0));
+            }
+        }
+    }
+    // The README's sum loop: ++, != and * together.
+    template<typename P, typename E> void op_sum_loop(fixture<P, E>& f, std::size_t passes) {
+        unsigned sum = 0;
+        P begin = f.base;
+        std::size_t n = f.pointers.size();
+        for(std::size_t pass = 0; pass < passes; pass++) {
+            for(P it = begin; it != begin + n; it++) {
+                sum += (*it).bytes[0];
+            }
+        }
+        bench::do_not_optimize(sum);
+    }
+
+    template<typename E> struct named_kernel {
+        const char* name;
+        void (*raw)(fixture<E*, E>&, std::size_t);
+        void (*floating)(fixture<floating_pointer<E>, E>&, std::size_t);
+    };
+
+    #define KERNEL(label, fn) named_kernel<E>{label, fn<E*, E>, fn<floating_pointer<E>, E>}
+
+    template<std::size_t N>
+    void run_size(std::size_t ops) {
+        using E = element<N>;
+        // Keep the data L1-resident so the conversions, not cache misses, dominate.
+        std::size_t count = std::max<std::size_t>(256, (16 * 1024) / sizeof(E));
+        std::size_t passes = std::max<std::size_t>(1, ops / count);
+        std::vector<E> data(count);
+        bench::rng random;
+        for(E& e : data) {
+            e.bytes[0] = std::uint8_t(random());
+        }
+        std::vector<std::size_t> order(count);
+        for(std::size_t i = 0; i < count; i++) {
+            order[i] = i;
+        }
+        bench::shuffle(order, random);
+        fixture<E*, E> raw(data, order);
+        fixture<floating_pointer<E>, E> floating(data, order);
+
+        const named_kernel<E> kernels[] = {
+            KERNEL("operator*", op_deref),
+            KERNEL("operator->", op_arrow),
+            KERNEL("operator[]", op_subscript),
+            KERNEL("operator++", op_increment),
+            KERNEL("operator++(int)", op_post_increment),
+            KERNEL("operator--", op_decrement),
+            KERNEL("operator+=", op_plus_assign),
+            KERNEL("operator+", op_plus),
+            KERNEL("operator-", op_minus),
+            KERNEL("operator==", op_equal),
+            KERNEL("operator<", op_less),
+            KERNEL("sqrt", op_sqrt),
+            KERNEL("fma", op_fma),
+            KERNEL("fmod", op_fmod),
+            KERNEL("sum loop", op_sum_loop),
+        };
+
+        auto instructions = bench::instruction_counter();
+        std::size_t total = count * passes;
+        std::printf("\nsizeof(T) = %zu, %zu elements, %zu ops per repetition\n", N, count, total);
+        std::printf("%-18s %12s %12s %8s %14s %14s\n", "operation", "T* ns/op", "fp ns/op", "ratio", "T* instr/op",
+                    "fp instr/op");
+        for(const auto& k : kernels) {
+            auto r = bench::measure(total, instructions, [&] { k.raw(raw, passes); });
+            auto f = bench::measure(total, instructions, [&] { k.floating(floating, passes); });
+            std::printf("%-18s %12.3f %12.3f %8.2f %14s %14s\n", k.name, r.ns_per_op, f.ns_per_op,
+                        f.ns_per_op / r.ns_per_op, bench::format_events(r.events_per_op).c_str(),
+                        bench::format_events(f.events_per_op).c_str());
+        }
+    }
+
+    #undef KERNEL
+}
+
+int main() {
+    std::size_t ops = bench::env_size("BENCH_OPS", std::size_t(1) << 20);
+    if(!bench::instruction_counter().valid()) {
+        std::printf("note: perf_event_open unavailable, instruction counts disabled\n");
+    }
+    run_size<1>(ops);
+    run_size<4>(ops);
+    run_size<8>(ops);
+    run_size<16>(ops);
+    run_size<24>(ops);
+    run_size<64>(ops);
+}
@@ -0,0 +1,100 @@
+// Benchmark: object identity caches mapping pointers to metadata. floating_pointer_map against std::unordered_map keyed
+// by raw pointers and by floating pointers (through std::hash<floating_pointer>). Keys are the addresses of separately
+// allocated objects, inserted and then looked up in random order. Reported per key: build time (inserting every key
+// into an empty map, destruction included), lookup time for present and absent keys with LLC misses per hit lookup, and
+// churn (erase and reinsert of a random present key).
+//
+// Environment: BENCH_KEYS (largest key count, default 1<<20; counts grow by 16x from 1<<12).
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <floating_pointer_map.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+using based::floating_pointer_map;
+
+namespace {
+    struct object {
+        std::uint64_t payload[3];
+    };
+    struct metadata {
+        std::uint32_t type;
+        std::uint32_t generation;
+    };
+
+    template<typename Map>
+    void run(const char* name, std::size_t n) {
+        bench::rng random(n);
+        std::vector<std::unique_ptr<object>> objects;
+        std::vector<std::unique_ptr<object>> absent;
+        for(std::size_t i = 0; i < n; i++) {
+            objects.emplace_back(new object());
+            absent.emplace_back(new object());
+        }
+        std::vector<object*> keys;
+        std::vector<object*> misses;
+        for(std::size_t i = 0; i < n; i++) {
+            keys.push_back(objects[i].get());
+            misses.push_back(absent[i].get());
+        }
+        bench::shuffle(keys, random);
+        std::vector<object*> order = keys;
+        bench::shuffle(order, random);
+
+        auto counter = bench::instruction_counter();
+        auto build = bench::measure(n, counter, [&] {
+            Map map;
+            for(std::size_t i = 0; i < n; i++) {
+                map[keys[i]] = metadata{std::uint32_t(i), 0};
+            }
+            bench::do_not_optimize(map.size());
+        }, 3);
+
+        Map map;
+        for(std::size_t i = 0; i < n; i++) {
+            map[keys[i]] = metadata{std::uint32_t(i), 0};
+        }
+        auto llc = bench::llc_miss_counter();
+        auto hit = bench::measure(n, llc, [&] {
+            std::uint64_t sum = 0;
+            for(object* k : order) {
+                sum += map.find(k)->second.type;
+            }
+            bench::do_not_optimize(sum);
+        }, 3);
+        auto miss = bench::measure(n, counter, [&] {
+            std::size_t found = 0;
+            for(object* k : misses) {
+                found += map.find(k) != map.end();
+            }
+            bench::do_not_optimize(found);
+        }, 3);
+        auto churn = bench::measure(n, counter, [&] {
+            for(object* k : order) {
+                map.erase(k);
+                map[k] = metadata{0, 1};
+            }
+            bench::do_not_optimize(map.size());
+        }, 3);
+        std::printf("%-36s %9zu %10.1f %10.1f %10.1f %10s %10.1f\n", name, n, build.ns_per_op, hit.ns_per_op,
+                    miss.ns_per_op, bench::format_events(hit.events_per_op).c_str(), churn.ns_per_op);
+    }
+}
+
+int main() {
+    std::size_t max_keys = bench::env_size("BENCH_KEYS", std::size_t(1) << 20);
+    std::printf("%-36s %9s %10s %10s %10s %10s %10s\n", "map", "keys", "build ns", "hit ns", "miss ns", "hit LLC",
+                "churn ns");
+    for(std::size_t n = std::size_t(1) << 12; n <= max_keys; n *= 16) {
+        run<std::unordered_map<object*, metadata>>("std::unordered_map<T*>", n);
+        run<std::unordered_map<floating_pointer<object>, metadata>>("std::unordered_map<floating_pointer>", n);
+        run<floating_pointer_map<object, metadata>>("floating_pointer_map", n);
+    }
+}
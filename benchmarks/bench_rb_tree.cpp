@@ -0,0 +1,75 @@
+// Benchmark: inserting, finding and erasing random 64 bit keys in floating_rb_tree against std::map. The tree keeps the
+// node color in the sign bit of the parent pointer, so its nodes are one word smaller than libstdc++'s.
+//
+// Environment: BENCH_KEYS (largest key count, default 1<<20; the README's 100M runs use 100000000). Every power of 16
+// from 1<<16 up to BENCH_KEYS is run, then BENCH_KEYS itself.
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include <floating_rb_tree.hpp>
+
+#include "bench.hpp"
+
+using based::floating_rb_tree;
+
+namespace {
+    using key = std::uint64_t;
+
+    template<typename Map>
+    void run(const char* name, std::size_t node_bytes, const std::vector<key>& keys, const std::vector<key>& order) {
+        auto counter = bench::llc_miss_counter();
+        std::size_t n = keys.size();
+        Map map;
+        // Inserting and erasing change the map, so those phases run once
+        auto start = bench::clock::now();
+        for(key k : keys) {
+            map.try_emplace(k, k);
+        }
+        double insert_ns = bench::elapsed_ns(start, bench::clock::now()) / double(n);
+        auto find = bench::measure(n, counter, [&] {
+            key sum = 0;
+            for(key k : order) {
+                sum += map.find(k)->second;
+            }
+            bench::do_not_optimize(sum);
+        }, 3);
+        start = bench::clock::now();
+        for(key k : order) {
+            map.erase(k);
+        }
+        double erase_ns = bench::elapsed_ns(start, bench::clock::now()) / double(n);
+        std::printf("%-18s %10zu %8zu %12.1f %12.1f %12.1f %12s\n", name, n, node_bytes, insert_ns, find.ns_per_op,
+                    erase_ns, bench::format_events(find.events_per_op).c_str());
+    }
+
+    void run_size(std::size_t n) {
+        bench::rng random(n);
+        std::vector<key> keys(n);
+        for(auto& k : keys) {
+            k = random();
+        }
+        std::vector<key> order = keys;
+        bench::shuffle(order, random);
+        #ifdef __GLIBCXX__
+        std::size_t map_node = sizeof(std::_Rb_tree_node_base) + sizeof(std::pair<const key, key>);
+        #else
+        std::size_t map_node = 0;
+        #endif
+        run<std::map<key, key>>("std::map", map_node, keys, order);
+        run<floating_rb_tree<key, key>>("floating_rb_tree", floating_rb_tree<key, key>::node_size, keys, order);
+    }
+}
+
+int main() {
+    std::size_t max_keys = bench::env_size("BENCH_KEYS", std::size_t(1) << 20);
+    std::printf("%-18s %10s %8s %12s %12s %12s %12s\n", "map", "keys", "node B", "insert ns", "find ns", "erase ns",
+                "find LLC");
+    std::size_t n = std::size_t(1) << 16;
+    for(; n < max_keys; n <<= 4) {
+        run_size(n);
+    }
+    run_size(max_keys);
+}
@@ -0,0 +1,121 @@
+// Benchmark: read-mostly lookups under concurrent deletes. Reader threads look up random keys in a floating_harris_set
+// while one writer thread keeps erasing and reinserting random keys, so nodes are retired and must be reclaimed for the
+// whole run. The set retires through floating_epoch_domain or floating_hazard_domain, against std::set behind a
+// std::shared_mutex. Reported numbers are millions of lookups per second across all readers, and the writer's millions
+// of erase/insert pairs per second meanwhile.
+//
+// Environment: BENCH_THREADS (maximum reader count, default 2 * hardware concurrency), BENCH_OPS (lookups per reader,
+// default 1<<20), BENCH_KEYS (key range, default 256).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <floating_harris_set.hpp>
+#include <floating_reclamation.hpp>
+
+#include "bench.hpp"
+
+using based::floating_epoch_domain;
+using based::floating_harris_set;
+using based::floating_hazard_domain;
+
+namespace {
+    struct shared_mutex_set {
+        std::shared_mutex lock;
+        std::set<std::uint64_t> set;
+        bool insert(std::uint64_t k) {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            return set.insert(k).second;
+        }
+        bool erase(std::uint64_t k) {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            return set.erase(k);
+        }
+        bool contains(std::uint64_t k) {
+            std::shared_lock<std::shared_mutex> guard(lock);
+            return set.count(k);
+        }
+    };
+
+    using epoch_set = floating_harris_set<std::uint64_t, std::less<std::uint64_t>, floating_epoch_domain>;
+    using hazard_set = floating_harris_set<std::uint64_t, std::less<std::uint64_t>, floating_hazard_domain>;
+
+    struct result {
+        double lookups;
+        double updates;
+    };
+
+    template<typename Set>
+    result run(std::size_t readers, std::size_t ops, std::size_t keys) {
+        result best{0, 0};
+        for(int repetition = 0; repetition < 3; repetition++) {
+            Set set;
+            for(std::uint64_t k = 0; k < keys; k++) {
+                set.insert(k);
+            }
+            std::atomic<std::size_t> ready{0};
+            std::atomic<std::size_t> finished{0};
+            std::atomic<bool> go{false};
+            std::size_t updates = 0;
+            std::vector<std::thread> pool;
+            for(std::size_t t = 0; t < readers; t++) {
+                pool.emplace_back([&, t] {
+                    bench::rng random(t + 1);
+                    ready++;
+                    while(!go.load(std::memory_order_acquire)) {}
+                    std::size_t found = 0;
+                    for(std::size_t i = 0; i < ops; i++) {
+                        found += set.contains(random.below(keys));
+                    }
+                    bench::do_not_optimize(found);
+                    finished++;
+                });
+            }
+            pool.emplace_back([&] {
+                bench::rng random(0);
+                ready++;
+                while(!go.load(std::memory_order_acquire)) {}
+                while(finished.load(std::memory_order_relaxed) != readers) {
+                    std::uint64_t k = random.below(keys);
+                    set.erase(k);
+                    set.insert(k);
+                    updates++;
+                }
+            });
+            while(ready.load() != readers + 1) {}
+            auto start = bench::clock::now();
+            go.store(true, std::memory_order_release);
+            for(auto& thread : pool) {
+                thread.join();
+            }
+            double ns = bench::elapsed_ns(start, bench::clock::now());
+            best.lookups = std::max(best.lookups, double(readers * ops) / ns * 1e3);
+            best.updates = std::max(best.updates, double(updates) / ns * 1e3);
+        }
+        return best;
+    }
+}
+
+int main() {
+    std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t max_threads = bench::env_size("BENCH_THREADS", 2 * hardware);
+    std::size_t ops = bench::env_size("BENCH_OPS", std::size_t(1) << 20);
+    std::size_t keys = bench::env_size("BENCH_KEYS", 256);
+    std::printf("millions of lookups (updates) per second, %zu lookups per reader, %zu keys, one writer\n", ops, keys);
+    std::printf("%8s %24s %24s %24s\n", "readers", "shared_mutex std::set", "harris_set epochs", "harris_set hazards");
+    for(std::size_t readers = 1; readers <= max_threads; readers *= 2) {
+        result s = run<shared_mutex_set>(readers, ops, keys);
+        result e = run<epoch_set>(readers, ops, keys);
+        result h = run<hazard_set>(readers, ops, keys);
+        std::printf("%8zu %14.2f (%7.2f) %14.2f (%7.2f) %14.2f (%7.2f)\n", readers, s.lookups, s.updates, e.lookups,
+                    e.updates, h.lookups, h.updates);
+    }
+}
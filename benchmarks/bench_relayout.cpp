@@ -0,0 +1,140 @@
+// Benchmark: traversal speed of a binary search tree before and after relayout. The tree is built by random insertion
+// with its nodes scattered through the heap between short-lived filler allocations, as in a long-running process. It is
+// then copied into an arena in breadth first, depth first and hot path order, the hot path profile counting how often
+// a skewed lookup workload (mostly the lowest sixteenth of the keys) passes through each node. Reported: ns per skewed
+// lookup, ns per node of an in-order walk, LLC misses per lookup, and the time relayout took per node.
+//
+// Environment: BENCH_NODES (tree size, default 1<<20), BENCH_LOOKUPS (default 1<<20).
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <floating_relayout.hpp>
+
+#include "bench.hpp"
+
+using based::floating_arena;
+using based::floating_pointer;
+using based::relayout_order;
+
+namespace {
+    struct node {
+        floating_pointer<node> left;
+        floating_pointer<node> right;
+        std::uint64_t key;
+        std::uint64_t heat;
+        std::uint64_t payload[2];
+    };
+
+    auto edges = [](node& n, auto&& f) {
+        f(n.left);
+        f(n.right);
+    };
+
+    floating_pointer<node> find(floating_pointer<node> n, std::uint64_t key) {
+        while(n && n->key != key) {
+            n = key < n->key ? n->left : n->right;
+        }
+        return n;
+    }
+
+    std::uint64_t walk(floating_pointer<node> n) {
+        std::uint64_t sum = 0;
+        while(n) {
+            sum += walk(n->left) + n->key;
+            n = n->right;
+        }
+        return sum;
+    }
+
+    void report(const char* name, floating_pointer<node> root, const std::vector<std::uint64_t>& lookups,
+                std::size_t nodes, double relayout_ns) {
+        auto llc = bench::llc_miss_counter();
+        auto lookup = bench::measure(lookups.size(), llc, [&] {
+            std::uint64_t found = 0;
+            for(std::uint64_t k : lookups) {
+                found += find(root, k)->payload[0];
+            }
+            bench::do_not_optimize(found);
+        }, 3);
+        auto counter = bench::instruction_counter();
+        auto in_order = bench::measure(nodes, counter, [&] {
+            bench::do_not_optimize(walk(root));
+        }, 3);
+        std::printf("%-14s %12.1f %12.2f %12s %14.1f\n", name, lookup.ns_per_op, in_order.ns_per_op,
+                    bench::format_events(lookup.events_per_op).c_str(), relayout_ns);
+    }
+}
+
+int main() {
+    std::size_t n = bench::env_size("BENCH_NODES", std::size_t(1) << 20);
+    std::size_t lookup_count = bench::env_size("BENCH_LOOKUPS", std::size_t(1) << 20);
+    bench::rng random(n);
+
+    std::vector<std::uint64_t> keys(n);
+    for(std::size_t i = 0; i < n; i++) {
+        keys[i] = 2 * i;
+    }
+    bench::shuffle(keys, random);
+    std::vector<node*> nodes;
+    std::vector<void*> fillers;
+    floating_pointer<node> root = nullptr;
+    for(std::uint64_t k : keys) {
+        fillers.push_back(std::malloc(16 + random.below(240)));
+        node* fresh = new node{nullptr, nullptr, k, 0, {k, k}};
+        nodes.push_back(fresh);
+        if(!root) {
+            root = fresh;
+            continue;
+        }
+        floating_pointer<node> p = root;
+        for(;;) {
+            floating_pointer<node>& next = k < p->key ? p->left : p->right;
+            if(!next) {
+                next = fresh;
+                break;
+            }
+            p = next;
+        }
+    }
+    for(void* f : fillers) {
+        std::free(f);
+    }
+
+    // Skewed lookups: seven in eight go to the lowest sixteenth of the keys
+    std::vector<std::uint64_t> lookups(lookup_count);
+    for(auto& k : lookups) {
+        std::size_t range = random.below(8) ? n / 16 : n;
+        k = 2 * random.below(range);
+    }
+    for(std::uint64_t k : lookups) {
+        for(floating_pointer<node> p = root; p; p = k < p->key ? p->left : p->right) {
+            p->heat++;
+            if(p->key == k) {
+                break;
+            }
+        }
+    }
+
+    std::printf("%zu nodes of %zu bytes, %zu lookups\n", n, sizeof(node), lookup_count);
+    std::printf("%-14s %12s %12s %12s %14s\n", "layout", "lookup ns", "walk ns/node", "lookup LLC", "relayout ns/node");
+    report("scattered", root, lookups, n, 0);
+    floating_arena bfs_arena, dfs_arena, hot_arena;
+    auto start = bench::clock::now();
+    auto bfs = based::relayout(root, bfs_arena, edges, relayout_order::breadth_first);
+    double bfs_ns = bench::elapsed_ns(start, bench::clock::now()) / double(n);
+    start = bench::clock::now();
+    auto dfs = based::relayout(root, dfs_arena, edges, relayout_order::depth_first);
+    double dfs_ns = bench::elapsed_ns(start, bench::clock::now()) / double(n);
+    start = bench::clock::now();
+    auto hot = based::relayout(root, hot_arena, edges, [](const node& x) { return x.heat; });
+    double hot_ns = bench::elapsed_ns(start, bench::clock::now()) / double(n);
+    report("breadth first", bfs, lookups, n, bfs_ns);
+    report("depth first", dfs, lookups, n, dfs_ns);
+    report("hot path", hot, lookups, n, hot_ns);
+    for(node* p : nodes) {
+        delete p;
+    }
+}
@@ -0,0 +1,132 @@
+// Benchmark: floating_pointer<T, Repr> for every representation backend against raw T*.
+//
+// The data lives in a buffer mapped below 2^24 when the kernel allows it, so that even float can hold its addresses
+// exactly; backends that cannot are reported as n/a. The same source is built as bench_repr_checked with
+// FLOATING_POINTERS_CHECKED defined, to show the cost of trapping on precision loss at construction.
+//
+// Environment: BENCH_ELEMENTS (elements in the buffer, default 1<<20).
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include <floating_pointers.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+
+namespace {
+    using element = std::uint32_t;
+
+    template<typename P> struct backend_name;
+    template<> struct backend_name<element*> {
+        static constexpr const char* value = "T*";
+    };
+    template<> struct backend_name<floating_pointer<element, double>> {
+        static constexpr const char* value = "double";
+    };
+    template<> struct backend_name<floating_pointer<element, float>> {
+        static constexpr const char* value = "float";
+    };
+    template<> struct backend_name<floating_pointer<element, long double>> {
+        static constexpr const char* value = "long double";
+    };
+    #ifdef FLOATING_POINTERS_HAS_FLOAT128
+    template<> struct backend_name<floating_pointer<element, __float128>> {
+        static constexpr const char* value = "__float128";
+    };
+    #endif
+
+    template<typename P> bool exact(element* first, element* last) {
+        for(element* e : {first, last}) {
+            if(static_cast<element*>(P(e)) != e) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename P>
+    void run(element* data, std::size_t count, const std::vector<std::size_t>& order) {
+        if(!exact<P>(data, data + count)) {
+            std::printf("%-12s %8zu %12s %12s %12s %12s\n", backend_name<P>::value, sizeof(P), "n/a", "n/a", "n/a",
+                        "n/a");
+            return;
+        }
+        std::vector<element*> raw(order.size());
+        for(std::size_t i = 0; i < order.size(); i++) {
+            raw[i] = data + order[i];
+        }
+        std::vector<P> pointers(raw.begin(), raw.end());
+        auto counter = bench::instruction_counter();
+        auto construct = bench::measure(count, counter, [&] {
+            for(std::size_t i = 0; i < count; i++) {
+                pointers[i] = P(raw[i]);
+            }
+            bench::clobber();
+        });
+        auto sum_loop = bench::measure(count, counter, [&] {
+            element sum = 0;
+            P first = data;
+            for(P it = first; it != first + count; it++) {
+                sum += *it;
+            }
+            bench::do_not_optimize(sum);
+        });
+        auto gather = bench::measure(count, counter, [&] {
+            element sum = 0;
+            for(const P& p : pointers) {
+                sum += *p;
+            }
+            bench::do_not_optimize(sum);
+        });
+        auto increment = bench::measure(count, counter, [&] {
+            P it = data;
+            for(std::size_t i = 0; i < count; i++) {
+                ++it;
+                bench::do_not_optimize(it);
+            }
+        });
+        std::printf("%-12s %8zu %12.3f %12.3f %12.3f %12.3f\n", backend_name<P>::value, sizeof(P), construct.ns_per_op,
+                    sum_loop.ns_per_op, gather.ns_per_op, increment.ns_per_op);
+    }
+
+    // Tries to place the buffer low enough for float; falls back to wherever the kernel puts it
+    element* map_low(std::size_t bytes) {
+        void* hint = reinterpret_cast<void*>(std::uintptr_t(1) << 20);
+        void* p = mmap(hint, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p == MAP_FAILED ? nullptr : static_cast<element*>(p);
+    }
+}
+
+int main() {
+    std::size_t count = bench::env_size("BENCH_ELEMENTS", std::size_t(1) << 20);
+    element* data = map_low(count * sizeof(element));
+    if(!data) {
+        std::perror("mmap");
+        return 1;
+    }
+    bench::rng random;
+    std::vector<std::size_t> order(count);
+    for(std::size_t i = 0; i < count; i++) {
+        data[i] = element(random());
+        order[i] = i;
+    }
+    bench::shuffle(order, random);
+    #ifdef FLOATING_POINTERS_CHECKED
+    std::printf("checked construction\n");
+    #endif
+    std::printf("buffer at %p, ns per element\n", static_cast<void*>(data));
+    std::printf("%-12s %8s %12s %12s %12s %12s\n", "repr", "bytes", "construct", "sum loop", "gather", "increment");
+    run<element*>(data, count, order);
+    run<floating_pointer<element, double>>(data, count, order);
+    run<floating_pointer<element, float>>(data, count, order);
+    run<floating_pointer<element, long double>>(data, count, order);
+    #ifdef FLOATING_POINTERS_HAS_FLOAT128
+    run<floating_pointer<element, __float128>>(data, count, order);
+    #endif
+    munmap(data, count * sizeof(element));
+}
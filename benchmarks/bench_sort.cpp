@@ -0,0 +1,70 @@
+// Benchmark: sorting arrays of pointers by address, as done to batch frees. floating_sort against std::sort of the
+// same floating pointers with total_order_less and with operator<, and std::sort of the equivalent raw pointers.
+// Pointers are addresses into one large allocation in random order. Small sizes sort many independent arrays. Reported
+// numbers are ns per element, copying the unsorted input included.
+//
+// Environment: BENCH_ELEMENTS (largest array, default 1<<24; counts grow by 16x from 64; set it to 100000000 for the
+// 100M element run).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <floating_sort.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+
+namespace {
+    struct object {
+        std::uint64_t payload[2];
+    };
+
+    // Sorts batches arrays of n elements taken from input
+    using pointer = floating_pointer<object>;
+
+    template<typename P, typename Sort>
+    double run(const std::vector<P>& input, std::size_t n, std::size_t batches, Sort sort) {
+        std::vector<P> work(n);
+        auto counter = bench::instruction_counter();
+        return bench::measure(n * batches, counter, [&] {
+            for(std::size_t b = 0; b < batches; b++) {
+                std::copy(input.begin() + b * n, input.begin() + (b + 1) * n, work.begin());
+                sort(work.data(), work.data() + n);
+                bench::do_not_optimize(work[n / 2]);
+            }
+        }, 3).ns_per_op;
+    }
+}
+
+int main() {
+    std::size_t max_elements = bench::env_size("BENCH_ELEMENTS", std::size_t(1) << 24);
+    std::printf("ns per element\n");
+    std::printf("%11s %12s %16s %16s %14s\n", "elements", "std::sort T*", "std::sort <", "std::sort total",
+                "floating_sort");
+    for(std::size_t n = 64; n <= max_elements; n *= 16) {
+        std::size_t batches = std::max<std::size_t>(1, (std::size_t(1) << 20) / n);
+        std::vector<object> objects(std::max<std::size_t>(n, 1 << 16));
+        bench::rng random(n);
+        std::vector<object*> raw(n * batches);
+        for(auto& p : raw) {
+            p = &objects[random.below(objects.size())];
+        }
+        std::vector<pointer> floating(raw.begin(), raw.end());
+        double raw_sort = run(raw, n, batches, [](object** first, object** last) {
+            std::sort(first, last);
+        });
+        double less_sort = run(floating, n, batches, [](pointer* first, pointer* last) {
+            std::sort(first, last);
+        });
+        double total_sort = run(floating, n, batches, [](pointer* first, pointer* last) {
+            std::sort(first, last, based::total_order_less());
+        });
+        double radix_sort = run(floating, n, batches, [](pointer* first, pointer* last) {
+            based::floating_sort(first, last);
+        });
+        std::printf("%11zu %12.2f %16.2f %16.2f %14.2f\n", n, raw_sort, less_sort, total_sort, radix_sort);
+    }
+}
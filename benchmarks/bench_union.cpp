@@ -0,0 +1,165 @@
+// Benchmark: evaluating a mixed array of small shape nodes through virtual dispatch against floating_pointer_union's
+// table dispatch. The virtual nodes carry a vtable pointer; the union nodes are plain structs and the type lives in
+// the pointer. Nodes are visited in allocation order with the types either grouped (predictable dispatch) or shuffled.
+//
+// Environment: BENCH_NODES (nodes per array, default 1<<20).
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <floating_pointer_union.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+using based::floating_pointer_union;
+
+namespace {
+    namespace virtual_nodes {
+        struct shape {
+            virtual ~shape() = default;
+            virtual double area() const = 0;
+        };
+        struct circle : shape {
+            float r;
+            explicit circle(float r) : r(r) {}
+            double area() const override {
+                return 3.14159265358979 * r * r;
+            }
+        };
+        struct square : shape {
+            float s;
+            explicit square(float s) : s(s) {}
+            double area() const override {
+                return double(s) * s;
+            }
+        };
+        struct rectangle : shape {
+            float w, h;
+            rectangle(float w, float h) : w(w), h(h) {}
+            double area() const override {
+                return double(w) * h;
+            }
+        };
+    }
+
+    namespace plain_nodes {
+        struct circle {
+            float r;
+        };
+        struct square {
+            float s;
+        };
+        struct rectangle {
+            float w, h;
+        };
+        using shape = floating_pointer_union<circle, square, rectangle>;
+        struct area_of {
+            double operator()(floating_pointer<circle> c) const {
+                return 3.14159265358979 * c->r * c->r;
+            }
+            double operator()(floating_pointer<square> s) const {
+                return double(s->s) * s->s;
+            }
+            double operator()(floating_pointer<rectangle> r) const {
+                return double(r->w) * r->h;
+            }
+        };
+    }
+
+    // Both variants build the same sequence of kinds and sizes
+    std::vector<int> make_kinds(std::size_t count, bool shuffled) {
+        std::vector<int> kinds(count);
+        for(std::size_t i = 0; i < count; i++) {
+            kinds[i] = int(i * 3 / count);
+        }
+        if(shuffled) {
+            bench::rng random(count);
+            bench::shuffle(kinds, random);
+        }
+        return kinds;
+    }
+
+    void run(std::size_t count, bool shuffled) {
+        std::vector<int> kinds = make_kinds(count, shuffled);
+        auto counter = bench::instruction_counter();
+        const char* order = shuffled ? "shuffled" : "grouped";
+
+        std::vector<std::unique_ptr<virtual_nodes::shape>> virtual_owned;
+        std::vector<virtual_nodes::shape*> virtual_shapes;
+        std::size_t virtual_bytes = 0;
+        for(std::size_t i = 0; i < count; i++) {
+            float x = float(i % 100) + 1;
+            switch(kinds[i]) {
+                case 0:
+                    virtual_owned.emplace_back(new virtual_nodes::circle(x));
+                    virtual_bytes += sizeof(virtual_nodes::circle);
+                    break;
+                case 1:
+                    virtual_owned.emplace_back(new virtual_nodes::square(x));
+                    virtual_bytes += sizeof(virtual_nodes::square);
+                    break;
+                default:
+                    virtual_owned.emplace_back(new virtual_nodes::rectangle(x, 2));
+                    virtual_bytes += sizeof(virtual_nodes::rectangle);
+                    break;
+            }
+            virtual_shapes.push_back(virtual_owned.back().get());
+        }
+        auto virtual_m = bench::measure(count, counter, [&] {
+            double sum = 0;
+            for(auto s : virtual_shapes) {
+                sum += s->area();
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        std::vector<std::unique_ptr<plain_nodes::circle>> circles;
+        std::vector<std::unique_ptr<plain_nodes::square>> squares;
+        std::vector<std::unique_ptr<plain_nodes::rectangle>> rectangles;
+        std::vector<plain_nodes::shape> union_shapes;
+        std::size_t union_bytes = 0;
+        for(std::size_t i = 0; i < count; i++) {
+            float x = float(i % 100) + 1;
+            switch(kinds[i]) {
+                case 0:
+                    circles.emplace_back(new plain_nodes::circle{x});
+                    union_shapes.push_back(circles.back().get());
+                    union_bytes += sizeof(plain_nodes::circle);
+                    break;
+                case 1:
+                    squares.emplace_back(new plain_nodes::square{x});
+                    union_shapes.push_back(squares.back().get());
+                    union_bytes += sizeof(plain_nodes::square);
+                    break;
+                default:
+                    rectangles.emplace_back(new plain_nodes::rectangle{x, 2});
+                    union_shapes.push_back(rectangles.back().get());
+                    union_bytes += sizeof(plain_nodes::rectangle);
+                    break;
+            }
+        }
+        auto union_m = bench::measure(count, counter, [&] {
+            double sum = 0;
+            for(auto s : union_shapes) {
+                sum += s.visit(plain_nodes::area_of{});
+            }
+            bench::do_not_optimize(sum);
+        });
+
+        std::printf("%-30s %-9s %14.2f %12.3f %14s\n", "virtual", order, double(virtual_bytes) / double(count),
+                    virtual_m.ns_per_op, bench::format_events(virtual_m.events_per_op).c_str());
+        std::printf("%-30s %-9s %14.2f %12.3f %14s\n", "floating_pointer_union::visit", order,
+                    double(union_bytes) / double(count), union_m.ns_per_op,
+                    bench::format_events(union_m.events_per_op).c_str());
+    }
+}
+
+int main() {
+    std::size_t count = bench::env_size("BENCH_NODES", std::size_t(1) << 20);
+    std::printf("%zu nodes, a third each of circles, squares and rectangles\n", count);
+    std::printf("%-30s %-9s %14s %12s %14s\n", "dispatch", "order", "node bytes", "ns/call", "instructions");
+    run(count, false);
+    run(count, true);
+}
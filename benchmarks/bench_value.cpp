@@ -0,0 +1,174 @@
+// Benchmark: a small stack-based bytecode interpreter whose values are either NaN-boxed floating_values (8 bytes) or a
+// conventional tagged union (16 bytes). The program accumulates acc += cell.value * i over a loop counter, so it mixes
+// arithmetic on numbers with a field load through a heap object. The table shows the value size, time and instructions
+// per executed bytecode.
+//
+// Environment: BENCH_ITERATIONS (loop trips per run, default 1<<22).
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <floating_value.hpp>
+
+#include "bench.hpp"
+
+using based::floating_pointer;
+using based::floating_value;
+
+namespace {
+    struct cell {
+        double value;
+    };
+    constexpr unsigned cell_tag = 1;
+
+    struct tagged_value {
+        enum kind : std::uint32_t { number, object } tag;
+        union {
+            double num;
+            cell* ptr;
+        };
+    };
+    static_assert(sizeof(tagged_value) == 16);
+
+    // What the interpreter needs from a value representation
+    struct tagged_policy {
+        using value = tagged_value;
+        static value make_number(double d) {
+            value v;
+            v.tag = tagged_value::number;
+            v.num = d;
+            return v;
+        }
+        static value make_cell(cell* c) {
+            value v;
+            v.tag = tagged_value::object;
+            v.ptr = c;
+            return v;
+        }
+        static bool both_numbers(value a, value b) {
+            return a.tag == tagged_value::number && b.tag == tagged_value::number;
+        }
+        static bool is_cell(value v) {
+            return v.tag == tagged_value::object;
+        }
+        static double number(value v) {
+            return v.num;
+        }
+        static cell* as_cell(value v) {
+            return v.ptr;
+        }
+    };
+    struct boxed_policy {
+        using value = floating_value;
+        static value make_number(double d) {
+            return d;
+        }
+        static value make_cell(cell* c) {
+            return floating_value(floating_pointer<cell>(c), cell_tag);
+        }
+        static bool both_numbers(value a, value b) {
+            return a.is_number() && b.is_number();
+        }
+        static bool is_cell(value v) {
+            return v.has_tag(cell_tag);
+        }
+        static double number(value v) {
+            return v.as_number();
+        }
+        static cell* as_cell(value v) {
+            return v.as_pointer<cell>();
+        }
+    };
+
+    enum op : std::uint8_t { push_const, load, store, add, mul, less, field, jump_if, halt };
+    struct instruction {
+        op code;
+        std::uint32_t operand;
+    };
+
+    // locals: 0 = i, 1 = acc, 2 = cell, 3 = n
+    const std::vector<instruction> program = {
+        {load, 1}, {load, 2}, {field, 0}, {load, 0}, {mul, 0}, {add, 0}, {store, 1},
+        {load, 0}, {push_const, 1}, {add, 0}, {store, 0},
+        {load, 0}, {load, 3}, {less, 0}, {jump_if, 0},
+        {halt, 0}
+    };
+    constexpr std::size_t ops_per_iteration = 15;
+
+    // Returns acc, or NaN on a type error
+    template<typename P>
+    double interpret(const std::vector<instruction>& code, typename P::value* locals, const double* constants) {
+        using value = typename P::value;
+        value stack[16];
+        value* top = stack;
+        const instruction* pc = code.data();
+        for(;;) {
+            const instruction& in = *pc++;
+            switch(in.code) {
+                case push_const:
+                    *top++ = P::make_number(constants[in.operand]);
+                    break;
+                case load:
+                    *top++ = locals[in.operand];
+                    break;
+                case store:
+                    locals[in.operand] = *--top;
+                    break;
+                case add:
+                case mul:
+                case less: {
+                    value b = *--top;
+                    value a = top[-1];
+                    if(!P::both_numbers(a, b)) {
+                        return NAN;
+                    }
+                    double x = P::number(a), y = P::number(b);
+                    top[-1] = P::make_number(in.code == add ? x + y : in.code == mul ? x * y : double(x < y));
+                    break;
+                }
+                case field: {
+                    value v = top[-1];
+                    if(!P::is_cell(v)) {
+                        return NAN;
+                    }
+                    top[-1] = P::make_number(P::as_cell(v)->value);
+                    break;
+                }
+                case jump_if:
+                    if(P::number(*--top) != 0) {
+                        pc = code.data() + in.operand;
+                    }
+                    break;
+                case halt:
+                    return P::number(locals[1]);
+            }
+        }
+    }
+
+    template<typename P>
+    void run(const char* name, std::size_t iterations) {
+        using value = typename P::value;
+        cell c{0.5};
+        const double constants[] = {0, 1};
+        double result = 0;
+        auto counter = bench::instruction_counter();
+        auto m = bench::measure(iterations * ops_per_iteration, counter, [&] {
+            value locals[] = {
+                P::make_number(0), P::make_number(0), P::make_cell(&c), P::make_number(double(iterations))
+            };
+            result = interpret<P>(program, locals, constants);
+            bench::do_not_optimize(result);
+        });
+        std::printf("%-16s %8zu %12.3f %14s %16.0f\n", name, sizeof(value), m.ns_per_op,
+                    bench::format_events(m.events_per_op).c_str(), result);
+    }
+}
+
+int main() {
+    std::size_t iterations = bench::env_size("BENCH_ITERATIONS", std::size_t(1) << 22);
+    std::printf("%zu iterations, %zu bytecodes each\n", iterations, ops_per_iteration);
+    std::printf("%-16s %8s %12s %14s %16s\n", "value", "bytes", "ns/op", "instructions", "result");
+    run<tagged_policy>("tagged union", iterations);
+    run<boxed_policy>("floating_value", iterations);
+}
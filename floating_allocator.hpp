@@ -0,0 +1,53 @@
+#ifndef FLOATING_ALLOCATOR_HPP
+#define FLOATING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    // std::pmr::polymorphic_allocator, but with floating_pointer<T> as its pointer type. Any memory resource can back
+    // it, and containers that honor allocator_traits<A>::pointer store floating pointers internally.
+    template<typename T>
+    class floating_allocator {
+        std::pmr::memory_resource* _resource;
+        template<typename> friend class floating_allocator;
+    public:
+        using value_type = T;
+        using pointer = floating_pointer<T>;
+        using const_pointer = floating_pointer<const T>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        floating_allocator() noexcept : _resource(std::pmr::get_default_resource()) {}
+        floating_allocator(std::pmr::memory_resource* resource) noexcept : _resource(resource) {}
+        floating_allocator(const floating_allocator&) = default;
+        template<typename U>
+        floating_allocator(const floating_allocator<U>& other) noexcept : _resource(other._resource) {}
+        floating_allocator& operator=(const floating_allocator&) = delete;
+        pointer allocate(std::size_t n) {
+            return pointer(static_cast<T*>(_resource->allocate(n * sizeof(T), alignof(T))));
+        }
+        void deallocate(pointer p, std::size_t n) {
+            _resource->deallocate(static_cast<T*>(p), n * sizeof(T), alignof(T));
+        }
+        // Like polymorphic_allocator, the resource does not follow a container on copy construction
+        floating_allocator select_on_container_copy_construction() const {
+            return floating_allocator();
+        }
+        std::pmr::memory_resource* resource() const {
+            return _resource;
+        }
+        template<typename U>
+        friend bool operator==(const floating_allocator& a, const floating_allocator<U>& b) noexcept {
+            return *a.resource() == *b.resource();
+        }
+        template<typename U>
+        friend bool operator!=(const floating_allocator& a, const floating_allocator<U>& b) noexcept {
+            return !(a == b);
+        }
+    };
+}
+
+#endif
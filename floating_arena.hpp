@@ -0,0 +1,105 @@
+#ifndef FLOATING_ARENA_HPP
+#define FLOATING_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    // A bump allocator handing out floating pointers. Memory is taken from the upstream resource in geometrically
+    // growing chunks and only returned all at once, by release() or the destructor, so tearing down a structure costs
+    // one upstream deallocation per chunk instead of one per object. Destructors are never run, so make<T> only accepts
+    // trivially destructible types.
+    //
+    // The arena is also a std::pmr::memory_resource and can back a floating_allocator.
+    class floating_arena : public std::pmr::memory_resource {
+        struct chunk {
+            chunk* next;
+            std::size_t size;
+        };
+        chunk* _chunks = nullptr;
+        std::uintptr_t _cursor = 0;
+        std::uintptr_t _end = 0;
+        std::size_t _initial_size;
+        std::size_t _next_size;
+        std::pmr::memory_resource* _upstream;
+
+        void* grow(std::size_t bytes, std::size_t alignment) {
+            std::size_t needed = sizeof(chunk) + bytes + alignment;
+            std::size_t size = _next_size;
+            while(size < needed) {
+                size *= 2;
+            }
+            chunk* c = static_cast<chunk*>(_upstream->allocate(size, alignof(std::max_align_t)));
+            c->next = _chunks;
+            c->size = size;
+            _chunks = c;
+            _cursor = std::uintptr_t(c) + sizeof(chunk);
+            _end = std::uintptr_t(c) + size;
+            _next_size = size * 2;
+            return do_allocate(bytes, alignment);
+        }
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            std::uintptr_t start = (_cursor + alignment - 1) & ~std::uintptr_t(alignment - 1);
+            if(start + bytes > _end || start < _cursor) {
+                return grow(bytes, alignment);
+            }
+            _cursor = start + bytes;
+            return reinterpret_cast<void*>(start);
+        }
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    public:
+        explicit floating_arena(
+            std::size_t initial_size = 64 * 1024,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+        ) : _initial_size(initial_size < 2 * sizeof(chunk) ? 2 * sizeof(chunk) : initial_size),
+            _next_size(_initial_size),
+            _upstream(upstream) {}
+        floating_arena(const floating_arena&) = delete;
+        floating_arena& operator=(const floating_arena&) = delete;
+        ~floating_arena() override {
+            release();
+        }
+        template<typename T, typename... Args>
+        floating_pointer<T> make(Args&&... args) {
+            static_assert(std::is_trivially_destructible<T>::value, "floating_arena never runs destructors");
+            return floating_pointer<T>(::new(do_allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+        }
+        // Default-initialized storage for n objects
+        template<typename T>
+        floating_pointer<T> make_array(std::size_t n) {
+            static_assert(std::is_trivially_destructible<T>::value, "floating_arena never runs destructors");
+            T* array = static_cast<T*>(do_allocate(n * sizeof(T), alignof(T)));
+            for(std::size_t i = 0; i < n; i++) {
+                ::new(static_cast<void*>(array + i)) T;
+            }
+            return floating_pointer<T>(array);
+        }
+        // Frees every object at once. The cost is one upstream deallocation per chunk, logarithmic in the bytes used.
+        // Chunk sizes start over from the initial size, so release and rebuild cycles do not keep growing them.
+        void release() {
+            while(_chunks) {
+                chunk* next = _chunks->next;
+                _upstream->deallocate(_chunks, _chunks->size, alignof(std::max_align_t));
+                _chunks = next;
+            }
+            _cursor = 0;
+            _end = 0;
+            _next_size = _initial_size;
+        }
+        std::pmr::memory_resource* upstream_resource() const {
+            return _upstream;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef FLOATING_ATOMIC_HPP
+#define FLOATING_ATOMIC_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "floating_pointers.hpp"
+
+// Atomic floating pointers, lock-free wherever 64 bit atomics are. Compare-and-swap compares bit patterns, not values:
+// a negative null pointer does not match nullptr, and a nan pointer matches itself. fetch_add and fetch_sub advance by
+// whole elements like operator+= and are compare-and-swap loops, since there is no atomic floating add. wait and the
+// notify functions (C++20) forward to std::atomic<std::uint64_t>, which the standard libraries implement with futexes
+// on Linux.
+template<typename T>
+struct std::atomic<based::floating_pointer<T>> {
+private:
+    std::atomic<std::uint64_t> _bits;
+    static std::uint64_t to_bits(based::floating_pointer<T> ptr) {
+        return based::detail::pointer_bits(ptr);
+    }
+    static based::floating_pointer<T> from_bits(std::uint64_t bits) {
+        return based::detail::pointer_from_bits<T>(bits);
+    }
+public:
+    using value_type = based::floating_pointer<T>;
+    using difference_type = std::ptrdiff_t;
+    static constexpr bool is_always_lock_free = std::atomic<std::uint64_t>::is_always_lock_free;
+
+    constexpr atomic() noexcept : _bits(0) {}
+    atomic(value_type desired) noexcept : _bits(to_bits(desired)) {}
+    atomic(const atomic&) = delete;
+    atomic& operator=(const atomic&) = delete;
+
+    bool is_lock_free() const noexcept {
+        return _bits.is_lock_free();
+    }
+    void store(value_type desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        _bits.store(to_bits(desired), order);
+    }
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return from_bits(_bits.load(order));
+    }
+    operator value_type() const noexcept {
+        return load();
+    }
+    value_type operator=(value_type desired) noexcept {
+        store(desired);
+        return desired;
+    }
+    value_type exchange(value_type desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return from_bits(_bits.exchange(to_bits(desired), order));
+    }
+
+    // On failure expected receives the current value
+    bool compare_exchange_weak(value_type& expected, value_type desired, std::memory_order success,
+                               std::memory_order failure) noexcept {
+        std::uint64_t bits = to_bits(expected);
+        bool exchanged = _bits.compare_exchange_weak(bits, to_bits(desired), success, failure);
+        expected = from_bits(bits);
+        return exchanged;
+    }
+    bool compare_exchange_strong(value_type& expected, value_type desired, std::memory_order success,
+                                 std::memory_order failure) noexcept {
+        std::uint64_t bits = to_bits(expected);
+        bool exchanged = _bits.compare_exchange_strong(bits, to_bits(desired), success, failure);
+        expected = from_bits(bits);
+        return exchanged;
+    }
+    bool compare_exchange_weak(value_type& expected, value_type desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return compare_exchange_weak(expected, desired, order, failure_order(order));
+    }
+    bool compare_exchange_strong(value_type& expected, value_type desired,
+                                 std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return compare_exchange_strong(expected, desired, order, failure_order(order));
+    }
+
+    value_type fetch_add(difference_type n, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        value_type old = load(std::memory_order_relaxed);
+        while(!compare_exchange_weak(old, old + n, order, std::memory_order_relaxed)) {}
+        return old;
+    }
+    value_type fetch_sub(difference_type n, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        value_type old = load(std::memory_order_relaxed);
+        while(!compare_exchange_weak(old, old - n, order, std::memory_order_relaxed)) {}
+        return old;
+    }
+    value_type operator+=(difference_type n) noexcept {
+        return fetch_add(n) + n;
+    }
+    value_type operator-=(difference_type n) noexcept {
+        return fetch_sub(n) - n;
+    }
+    value_type operator++() noexcept {
+        return fetch_add(1) + 1;
+    }
+    value_type operator--() noexcept {
+        return fetch_sub(1) - 1;
+    }
+    value_type operator++(int) noexcept {
+        return fetch_add(1);
+    }
+    value_type operator--(int) noexcept {
+        return fetch_sub(1);
+    }
+
+    #ifdef __cpp_lib_atomic_wait
+    // Blocks while the bits equal old's
+    void wait(value_type old, std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        _bits.wait(to_bits(old), order);
+    }
+    void notify_one() noexcept {
+        _bits.notify_one();
+    }
+    void notify_all() noexcept {
+        _bits.notify_all();
+    }
+    #endif
+private:
+    static constexpr std::memory_order failure_order(std::memory_order order) {
+        return order == std::memory_order_acq_rel ? std::memory_order_acquire
+             : order == std::memory_order_release ? std::memory_order_relaxed
+             : order;
+    }
+};
+
+#endif
@@ -0,0 +1,512 @@
+#ifndef FLOATING_BTREE_SET_HPP
+#define FLOATING_BTREE_SET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#if defined(__AVX512F__) || defined(__AVX__)
+ #include <immintrin.h>
+#elif defined(__SSE2__)
+ #include <emmintrin.h>
+#endif
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        // Keys per node: two cache lines of doubles, compared with one AVX-512, four AVX or eight SSE2 instructions
+        constexpr unsigned btree_width = 16;
+
+        inline unsigned popcount(std::uint32_t mask) {
+            #if defined(__GNUC__)
+            return unsigned(__builtin_popcount(mask));
+            #else
+            unsigned n = 0;
+            for(; mask; mask &= mask - 1) {
+                n++;
+            }
+            return n;
+            #endif
+        }
+
+        // The number of keys[0, count) less than key, or not greater than key when Inclusive, for sorted keys.
+        // keys must be 64 byte aligned. Every lane is compared, sorted or not, and the unused ones are masked off.
+        template<bool Inclusive, typename T>
+        unsigned btree_rank(const floating_pointer<T>* keys, unsigned count, floating_pointer<T> key) {
+            std::uint32_t mask = 0;
+            #if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+            // A floating_pointer is a double
+            const double* lanes = reinterpret_cast<const double*>(keys);
+            double k = from_bits(pointer_bits(key));
+            #endif
+            #if defined(__AVX512F__)
+            __m512d broadcast = _mm512_set1_pd(k);
+            for(unsigned i = 0; i < btree_width; i += 8) {
+                __m512d v = _mm512_load_pd(lanes + i);
+                mask |= std::uint32_t(_mm512_cmp_pd_mask(v, broadcast, Inclusive ? _CMP_LE_OQ : _CMP_LT_OQ)) << i;
+            }
+            #elif defined(__AVX__)
+            __m256d broadcast = _mm256_set1_pd(k);
+            for(unsigned i = 0; i < btree_width; i += 4) {
+                __m256d v = _mm256_load_pd(lanes + i);
+                __m256d lt = _mm256_cmp_pd(v, broadcast, Inclusive ? _CMP_LE_OQ : _CMP_LT_OQ);
+                mask |= std::uint32_t(_mm256_movemask_pd(lt)) << i;
+            }
+            #elif defined(__SSE2__)
+            __m128d broadcast = _mm_set1_pd(k);
+            for(unsigned i = 0; i < btree_width; i += 2) {
+                __m128d v = _mm_load_pd(lanes + i);
+                __m128d lt = Inclusive ? _mm_cmple_pd(v, broadcast) : _mm_cmplt_pd(v, broadcast);
+                mask |= std::uint32_t(_mm_movemask_pd(lt)) << i;
+            }
+            #else
+            for(unsigned i = 0; i < btree_width; i++) {
+                mask |= std::uint32_t(Inclusive ? keys[i] <= key : keys[i] < key) << i;
+            }
+            #endif
+            return popcount(mask & ((std::uint32_t(1) << count) - 1));
+        }
+    }
+
+    // An ordered set of floating pointers as a B+-tree, a replacement for std::set<T*> that does not chase a pointer
+    // per comparison. Nodes hold up to 16 keys in two aligned cache lines and are searched by comparing every key
+    // with the one sought at once as doubles (AVX-512, AVX or SSE2 as compiled for, else a plain loop), counting the
+    // lanes that compare less rather than branching on each. Inner nodes hold separators and children; all keys live
+    // in the leaves, which are linked in key order so range scans walk leaf arrays without returning to the inner
+    // nodes. Nodes other than the root are kept at least half full.
+    //
+    // Keys are ordered by operator<, which for ordinary pointers is address order; nullptr and negativenullptr are the
+    // same key, and NaN pointers must not be inserted. Iterators are forward iterators in key order; inserting or
+    // erasing invalidates all of them.
+    template<typename T>
+    class floating_btree_set {
+        static constexpr unsigned width = detail::btree_width;
+        static constexpr unsigned min_keys = width / 2;
+        using key = floating_pointer<T>;
+
+        struct node {
+            alignas(64) key keys[width];
+            unsigned count = 0;
+            node() {
+                std::fill(keys, keys + width, key(nullptr));
+            }
+        };
+        struct leaf : node {
+            floating_pointer<leaf> next = nullptr;
+        };
+        struct inner : node {
+            // children[i] holds keys below keys[i] and not below keys[i - 1]
+            floating_pointer<node> children[width + 1];
+        };
+
+        floating_pointer<node> _root = nullptr;
+        floating_pointer<leaf> _first = nullptr;
+        unsigned _height = 0; // levels of inner nodes
+        std::size_t _size = 0;
+
+        static leaf* as_leaf(floating_pointer<node> n) {
+            return static_cast<leaf*>(static_cast<node*>(n));
+        }
+        static inner* as_inner(floating_pointer<node> n) {
+            return static_cast<inner*>(static_cast<node*>(n));
+        }
+
+        // The leaf that holds or would hold k; path receives the inner nodes above it and the child taken in each
+        struct step {
+            inner* parent;
+            unsigned child;
+        };
+        leaf* descend(key k, step* path) const {
+            floating_pointer<node> n = _root;
+            for(unsigned level = 0; level < _height; level++) {
+                inner* in = as_inner(n);
+                unsigned child = detail::btree_rank<true>(in->keys, in->count, k);
+                if(path) {
+                    path[level] = {in, child};
+                }
+                n = in->children[child];
+            }
+            return as_leaf(n);
+        }
+        // The first position in or after l holding a key not less than k, or end
+        static std::pair<leaf*, unsigned> lower_bound_in(leaf* l, key k) {
+            unsigned i = detail::btree_rank<false>(l->keys, l->count, k);
+            if(i == l->count) {
+                return {l->next, 0};
+            }
+            return {l, i};
+        }
+        static std::pair<leaf*, unsigned> upper_bound_in(leaf* l, key k) {
+            unsigned i = detail::btree_rank<true>(l->keys, l->count, k);
+            if(i == l->count) {
+                return {l->next, 0};
+            }
+            return {l, i};
+        }
+
+        // Inserts separator and its right child after child in parent, which has room
+        static void insert_child(inner* parent, unsigned child, key separator, floating_pointer<node> right) {
+            std::copy_backward(parent->keys + child, parent->keys + parent->count, parent->keys + parent->count + 1);
+            std::copy_backward(parent->children + child + 1, parent->children + parent->count + 1,
+                               parent->children + parent->count + 2);
+            parent->keys[child] = separator;
+            parent->children[child + 1] = right;
+            parent->count++;
+        }
+        // Removes keys[i] and children[i + 1] from parent
+        static void remove_child(inner* parent, unsigned i) {
+            std::copy(parent->keys + i + 1, parent->keys + parent->count, parent->keys + i);
+            std::copy(parent->children + i + 2, parent->children + parent->count + 1, parent->children + i + 1);
+            parent->count--;
+        }
+
+        // Adds separator and right, split off a child on path[level], to the inner nodes above, splitting full ones
+        void insert_upwards(step* path, unsigned level, key separator, floating_pointer<node> right) {
+            while(level-- > 0) {
+                inner* parent = path[level].parent;
+                unsigned child = path[level].child;
+                if(parent->count < width) {
+                    insert_child(parent, child, separator, right);
+                    return;
+                }
+                // Lay out all width + 1 separators, push the middle one up and split the rest evenly
+                key keys[width + 1];
+                floating_pointer<node> children[width + 2];
+                std::copy(parent->keys, parent->keys + width, keys);
+                std::copy(parent->children, parent->children + width + 1, children);
+                std::copy_backward(keys + child, keys + width, keys + width + 1);
+                std::copy_backward(children + child + 1, children + width + 1, children + width + 2);
+                keys[child] = separator;
+                children[child + 1] = right;
+                constexpr unsigned half = (width + 1) / 2;
+                inner* sibling = new inner;
+                parent->count = half;
+                std::copy(keys, keys + half, parent->keys);
+                std::copy(children, children + half + 1, parent->children);
+                sibling->count = width - half;
+                std::copy(keys + half + 1, keys + width + 1, sibling->keys);
+                std::copy(children + half + 1, children + width + 2, sibling->children);
+                separator = keys[half];
+                right = sibling;
+            }
+            inner* root = new inner;
+            root->count = 1;
+            root->keys[0] = separator;
+            root->children[0] = _root;
+            root->children[1] = right;
+            _root = root;
+            _height++;
+        }
+
+        // Restores the half full invariant of the leaf below path[level] after an erase from it
+        void rebalance_leaf(step* path, unsigned level, leaf* l) {
+            inner* parent = path[level].parent;
+            unsigned i = path[level].child;
+            leaf* left = i > 0 ? as_leaf(parent->children[i - 1]) : nullptr;
+            leaf* right = i < parent->count ? as_leaf(parent->children[i + 1]) : nullptr;
+            if(left && left->count > min_keys) {
+                std::copy_backward(l->keys, l->keys + l->count, l->keys + l->count + 1);
+                l->keys[0] = left->keys[--left->count];
+                l->count++;
+                parent->keys[i - 1] = l->keys[0];
+                return;
+            }
+            if(right && right->count > min_keys) {
+                l->keys[l->count++] = right->keys[0];
+                std::copy(right->keys + 1, right->keys + right->count, right->keys);
+                right->count--;
+                parent->keys[i] = right->keys[0];
+                return;
+            }
+            // Merge the pair into its left leaf
+            if(left) {
+                std::copy(l->keys, l->keys + l->count, left->keys + left->count);
+                left->count += l->count;
+                left->next = l->next;
+                delete l;
+                remove_child(parent, i - 1);
+            } else {
+                std::copy(right->keys, right->keys + right->count, l->keys + l->count);
+                l->count += right->count;
+                l->next = right->next;
+                delete right;
+                remove_child(parent, i);
+            }
+            rebalance_inner(path, level);
+        }
+        // The same for the inner node path[level].parent, rotating separators through its parent
+        void rebalance_inner(step* path, unsigned level) {
+            inner* n = path[level].parent;
+            if(level == 0) {
+                if(n->count == 0) {
+                    _root = n->children[0];
+                    _height--;
+                    delete n;
+                }
+                return;
+            }
+            if(n->count >= min_keys) {
+                return;
+            }
+            inner* parent = path[level - 1].parent;
+            unsigned i = path[level - 1].child;
+            inner* left = i > 0 ? as_inner(parent->children[i - 1]) : nullptr;
+            inner* right = i < parent->count ? as_inner(parent->children[i + 1]) : nullptr;
+            if(left && left->count > min_keys) {
+                std::copy_backward(n->keys, n->keys + n->count, n->keys + n->count + 1);
+                std::copy_backward(n->children, n->children + n->count + 1, n->children + n->count + 2);
+                n->keys[0] = parent->keys[i - 1];
+                n->children[0] = left->children[left->count];
+                n->count++;
+                parent->keys[i - 1] = left->keys[--left->count];
+                return;
+            }
+            if(right && right->count > min_keys) {
+                n->keys[n->count] = parent->keys[i];
+                n->children[n->count + 1] = right->children[0];
+                n->count++;
+                parent->keys[i] = right->keys[0];
+                std::copy(right->keys + 1, right->keys + right->count, right->keys);
+                std::copy(right->children + 1, right->children + right->count + 1, right->children);
+                right->count--;
+                return;
+            }
+            inner* into = left ? left : n;
+            inner* from = left ? n : right;
+            unsigned separator = left ? i - 1 : i;
+            into->keys[into->count] = parent->keys[separator];
+            std::copy(from->keys, from->keys + from->count, into->keys + into->count + 1);
+            std::copy(from->children, from->children + from->count + 1, into->children + into->count + 1);
+            into->count += from->count + 1;
+            delete from;
+            remove_child(parent, separator);
+            rebalance_inner(path, level - 1);
+        }
+
+        // Copies the subtree n of the given level, appending its leaves to the chain after previous
+        floating_pointer<node> clone(floating_pointer<node> n, unsigned level, leaf*& previous) {
+            if(level == 0) {
+                leaf* copy = new leaf(*as_leaf(n));
+                copy->next = nullptr;
+                if(previous) {
+                    previous->next = copy;
+                } else {
+                    _first = copy;
+                }
+                previous = copy;
+                return copy;
+            }
+            inner* copy = new inner(*as_inner(n));
+            for(unsigned i = 0; i <= copy->count; i++) {
+                copy->children[i] = clone(copy->children[i], level - 1, previous);
+            }
+            return copy;
+        }
+        static void destroy(floating_pointer<node> n, unsigned level) {
+            if(level == 0) {
+                delete as_leaf(n);
+                return;
+            }
+            inner* in = as_inner(n);
+            for(unsigned i = 0; i <= in->count; i++) {
+                destroy(in->children[i], level - 1);
+            }
+            delete in;
+        }
+
+    public:
+        class const_iterator {
+            leaf* _leaf = nullptr;
+            unsigned _index = 0;
+            friend class floating_btree_set;
+            const_iterator(leaf* l, unsigned index) : _leaf(l), _index(index) {}
+            explicit const_iterator(std::pair<leaf*, unsigned> position)
+                : _leaf(position.first), _index(position.second) {}
+        public:
+            using value_type = floating_pointer<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const floating_pointer<T>*;
+            using reference = const floating_pointer<T>&;
+            using iterator_category = std::forward_iterator_tag;
+            const_iterator() = default;
+            reference operator*() const {
+                return _leaf->keys[_index];
+            }
+            pointer operator->() const {
+                return &_leaf->keys[_index];
+            }
+            const_iterator& operator++() {
+                if(++_index == _leaf->count) {
+                    _leaf = _leaf->next;
+                    _index = 0;
+                }
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+            friend bool operator==(const_iterator a, const_iterator b) {
+                return a._leaf == b._leaf && a._index == b._index;
+            }
+            friend bool operator!=(const_iterator a, const_iterator b) {
+                return !(a == b);
+            }
+        };
+        using iterator = const_iterator;
+        using key_type = floating_pointer<T>;
+        using value_type = floating_pointer<T>;
+        using size_type = std::size_t;
+
+        floating_btree_set() = default;
+        floating_btree_set(const floating_btree_set& other) : _height(other._height), _size(other._size) {
+            if(other._root) {
+                leaf* previous = nullptr;
+                _root = clone(other._root, _height, previous);
+            }
+        }
+        floating_btree_set(floating_btree_set&& other) noexcept
+            : _root(other._root), _first(other._first), _height(other._height), _size(other._size) {
+            other._root = nullptr;
+            other._first = nullptr;
+            other._height = 0;
+            other._size = 0;
+        }
+        floating_btree_set& operator=(floating_btree_set other) noexcept {
+            std::swap(_root, other._root);
+            std::swap(_first, other._first);
+            std::swap(_height, other._height);
+            std::swap(_size, other._size);
+            return *this;
+        }
+        ~floating_btree_set() {
+            clear();
+        }
+
+        std::pair<iterator, bool> insert(floating_pointer<T> k) {
+            if(!_root) {
+                leaf* l = new leaf;
+                _root = l;
+                _first = l;
+            }
+            step path[64];
+            leaf* l = descend(k, path);
+            unsigned i = detail::btree_rank<false>(l->keys, l->count, k);
+            if(i < l->count && l->keys[i] == k) {
+                return {iterator(l, i), false};
+            }
+            _size++;
+            if(l->count < width) {
+                std::copy_backward(l->keys + i, l->keys + l->count, l->keys + l->count + 1);
+                l->keys[i] = k;
+                l->count++;
+                return {iterator(l, i), true};
+            }
+            // Split the full leaf in half and insert into the half k falls in
+            leaf* right = new leaf;
+            std::copy(l->keys + min_keys, l->keys + width, right->keys);
+            right->count = width - min_keys;
+            l->count = min_keys;
+            right->next = l->next;
+            l->next = right;
+            leaf* target = i <= min_keys ? l : right;
+            unsigned j = i <= min_keys ? i : i - min_keys;
+            std::copy_backward(target->keys + j, target->keys + target->count, target->keys + target->count + 1);
+            target->keys[j] = k;
+            target->count++;
+            insert_upwards(path, _height, right->keys[0], right);
+            return {iterator(target, j), true};
+        }
+        template<typename It>
+        void insert(It first, It last) {
+            for(; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        std::size_t erase(floating_pointer<T> k) {
+            if(!_root) {
+                return 0;
+            }
+            step path[64];
+            leaf* l = descend(k, path);
+            unsigned i = detail::btree_rank<false>(l->keys, l->count, k);
+            if(i == l->count || !(l->keys[i] == k)) {
+                return 0;
+            }
+            std::copy(l->keys + i + 1, l->keys + l->count, l->keys + i);
+            l->count--;
+            _size--;
+            if(_height == 0) {
+                if(l->count == 0) {
+                    delete l;
+                    _root = nullptr;
+                    _first = nullptr;
+                }
+            } else if(l->count < min_keys) {
+                rebalance_leaf(path, _height - 1, l);
+            }
+            return 1;
+        }
+        // Returns the iterator following pos
+        iterator erase(const_iterator pos) {
+            key k = *pos;
+            erase(k);
+            return lower_bound(k);
+        }
+        void clear() {
+            if(_root) {
+                destroy(_root, _height);
+            }
+            _root = nullptr;
+            _first = nullptr;
+            _height = 0;
+            _size = 0;
+        }
+
+        iterator find(floating_pointer<T> k) const {
+            if(!_root) {
+                return end();
+            }
+            leaf* l = descend(k, nullptr);
+            unsigned i = detail::btree_rank<false>(l->keys, l->count, k);
+            if(i == l->count || !(l->keys[i] == k)) {
+                return end();
+            }
+            return iterator(l, i);
+        }
+        bool contains(floating_pointer<T> k) const {
+            return find(k) != end();
+        }
+        std::size_t count(floating_pointer<T> k) const {
+            return contains(k) ? 1 : 0;
+        }
+        // The first key not less than k; with upper_bound, bounds for range scans along the leaf chain
+        iterator lower_bound(floating_pointer<T> k) const {
+            return _root ? iterator(lower_bound_in(descend(k, nullptr), k)) : end();
+        }
+        // The first key greater than k
+        iterator upper_bound(floating_pointer<T> k) const {
+            return _root ? iterator(upper_bound_in(descend(k, nullptr), k)) : end();
+        }
+
+        iterator begin() const {
+            return iterator(_first && _first->count ? static_cast<leaf*>(_first) : nullptr, 0);
+        }
+        iterator end() const {
+            return iterator();
+        }
+        std::size_t size() const {
+            return _size;
+        }
+        bool empty() const {
+            return _size == 0;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,398 @@
+#ifndef FLOATING_CSR_GRAPH_HPP
+#define FLOATING_CSR_GRAPH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "floating_pointers.hpp"
+#include "floating_span.hpp"
+
+namespace based {
+    // A directed graph in compressed sparse row form: every adjacency list lives back to back in one edge buffer of
+    // vertex ids, and vertex v's list runs from offsets[v] to offsets[v + 1], floating pointers into that buffer. A
+    // neighbor walk is one load for the bounds and a sequential scan, where a std::vector per vertex costs a cache
+    // miss on the vector header and another on its heap block. Vertices are the ids 0 to vertex_count() - 1; Vertex
+    // must be an unsigned integer, its largest value is reserved as no_vertex. The graph is immutable once built.
+    template<typename Vertex = std::uint32_t>
+    class floating_csr_graph {
+        static_assert(std::is_unsigned<Vertex>::value, "vertex ids must be unsigned integers");
+        std::size_t _vertex_count = 0;
+        std::size_t _edge_count = 0;
+        std::unique_ptr<Vertex[]> _edges;
+        std::unique_ptr<floating_pointer<const Vertex>[]> _offsets; // vertex_count + 1 entries
+    public:
+        using vertex_type = Vertex;
+        static constexpr Vertex no_vertex = std::numeric_limits<Vertex>::max();
+
+        floating_csr_graph() : _offsets(new floating_pointer<const Vertex>[1]{nullptr}) {}
+        // From (source, target) pairs in any order, both below vertex_count. Each adjacency list keeps the order its
+        // edges were given in; duplicate edges and self loops are kept.
+        floating_csr_graph(std::size_t vertex_count, const std::vector<std::pair<Vertex, Vertex>>& edges)
+            : _vertex_count(vertex_count),
+              _edge_count(edges.size()),
+              _edges(new Vertex[edges.size()]),
+              _offsets(new floating_pointer<const Vertex>[vertex_count + 1]) {
+            // Counting sort by source
+            std::vector<std::size_t> start(vertex_count + 1);
+            for(const auto& e : edges) {
+                assert(e.first < vertex_count && e.second < vertex_count && "edge endpoint out of range");
+                start[std::size_t(e.first) + 1]++;
+            }
+            for(std::size_t v = 0; v < vertex_count; v++) {
+                start[v + 1] += start[v];
+            }
+            for(std::size_t v = 0; v <= vertex_count; v++) {
+                _offsets[v] = _edges.get() + start[v];
+            }
+            for(const auto& e : edges) {
+                _edges[start[e.first]++] = e.second;
+            }
+        }
+        // The offsets point into the edge buffer, so copies rebase them onto their own
+        floating_csr_graph(const floating_csr_graph& other)
+            : _vertex_count(other._vertex_count),
+              _edge_count(other._edge_count),
+              _edges(new Vertex[other._edge_count]),
+              _offsets(new floating_pointer<const Vertex>[other._vertex_count + 1]) {
+            std::copy(other._edges.get(), other._edges.get() + _edge_count, _edges.get());
+            for(std::size_t v = 0; v <= _vertex_count; v++) {
+                _offsets[v] = _edges.get() + (other._offsets[v] - floating_pointer<const Vertex>(other._edges.get()));
+            }
+        }
+        floating_csr_graph(floating_csr_graph&&) noexcept = default;
+        floating_csr_graph& operator=(const floating_csr_graph& other) {
+            if(this != &other) {
+                *this = floating_csr_graph(other);
+            }
+            return *this;
+        }
+        floating_csr_graph& operator=(floating_csr_graph&&) noexcept = default;
+
+        std::size_t vertex_count() const {
+            return _vertex_count;
+        }
+        std::size_t edge_count() const {
+            return _edge_count;
+        }
+        floating_span<const Vertex> neighbors(Vertex v) const {
+            return {_offsets[v], _offsets[v + 1]};
+        }
+        std::size_t degree(Vertex v) const {
+            return std::size_t(_offsets[v + 1] - _offsets[v]);
+        }
+        // The graph with every edge reversed: in-neighbors become neighbors
+        floating_csr_graph transpose() const {
+            std::vector<std::pair<Vertex, Vertex>> reversed;
+            reversed.reserve(_edge_count);
+            for(std::size_t v = 0; v < _vertex_count; v++) {
+                for(Vertex w : neighbors(Vertex(v))) {
+                    reversed.emplace_back(w, Vertex(v));
+                }
+            }
+            return floating_csr_graph(_vertex_count, reversed);
+        }
+    };
+
+    namespace detail {
+        // Work is handed out in blocks of this many items; a multiple of 64 so that bottom-up BFS blocks own whole
+        // words of the frontier bitmap
+        constexpr std::size_t graph_block = 256;
+
+        // A pool of threads - 1 workers, started once per algorithm and reused by every level or iteration, so that
+        // a BFS with thousands of levels does not create and join threads for each. run() is a barrier: it returns
+        // once every block is done.
+        class graph_workers {
+            std::vector<std::thread> _threads;
+            std::mutex _mutex;
+            std::condition_variable _start;
+            std::condition_variable _done;
+            std::size_t _generation = 0;
+            std::size_t _running = 0;
+            bool _stop = false;
+            // The current job, published under _mutex
+            void (*_call)(void*, std::size_t, std::size_t, unsigned) = nullptr;
+            void* _job = nullptr;
+            std::size_t _n = 0;
+            std::size_t _blocks = 0;
+            std::atomic<std::size_t> _next{0};
+
+            void work(unsigned t) {
+                for(std::size_t b; (b = _next.fetch_add(1, std::memory_order_relaxed)) < _blocks;) {
+                    _call(_job, b * graph_block, std::min(_n, (b + 1) * graph_block), t);
+                }
+            }
+            void loop(unsigned t) {
+                std::size_t seen = 0;
+                std::unique_lock<std::mutex> lock(_mutex);
+                while(true) {
+                    _start.wait(lock, [&] { return _stop || _generation != seen; });
+                    if(_stop) {
+                        return;
+                    }
+                    seen = _generation;
+                    lock.unlock();
+                    work(t);
+                    lock.lock();
+                    if(--_running == 0) {
+                        _done.notify_one();
+                    }
+                }
+            }
+        public:
+            explicit graph_workers(unsigned threads) {
+                for(unsigned t = 1; t < threads; t++) {
+                    _threads.emplace_back([this, t] { loop(t); });
+                }
+            }
+            graph_workers(const graph_workers&) = delete;
+            graph_workers& operator=(const graph_workers&) = delete;
+            ~graph_workers() {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _start.notify_all();
+                for(auto& t : _threads) {
+                    t.join();
+                }
+            }
+            unsigned size() const {
+                return unsigned(_threads.size()) + 1;
+            }
+            // Calls f(begin, end, thread) on blocks of [0, n), the caller taking part as thread 0. Blocks are taken
+            // from a shared counter so that skewed degrees do not leave threads idle. thread is below size(). A
+            // single block, such as a small BFS frontier, runs inline without waking the workers.
+            template<typename F>
+            void run(std::size_t n, F f) {
+                std::size_t blocks = (n + graph_block - 1) / graph_block;
+                if(blocks <= 1 || _threads.empty()) {
+                    if(n) {
+                        f(0, n, 0);
+                    }
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _call = [](void* job, std::size_t begin, std::size_t end, unsigned t) {
+                        (*static_cast<F*>(job))(begin, end, t);
+                    };
+                    _job = &f;
+                    _n = n;
+                    _blocks = blocks;
+                    _next.store(0, std::memory_order_relaxed);
+                    _running = _threads.size();
+                    _generation++;
+                }
+                _start.notify_all();
+                work(0);
+                std::unique_lock<std::mutex> lock(_mutex);
+                _done.wait(lock, [&] { return _running == 0; });
+            }
+        };
+
+        // No more threads than there are blocks of n items
+        inline unsigned graph_threads(unsigned threads, std::size_t n) {
+            std::size_t blocks = (n + graph_block - 1) / graph_block;
+            return unsigned(std::max<std::size_t>(1, std::min<std::size_t>(threads, blocks)));
+        }
+        inline unsigned lowest_bit64(std::uint64_t mask) {
+            #if defined(__GNUC__)
+            return unsigned(__builtin_ctzll(mask));
+            #else
+            unsigned i = 0;
+            while(!(mask & 1)) {
+                mask >>= 1;
+                i++;
+            }
+            return i;
+            #endif
+        }
+    }
+
+    // Breadth first search from source, returning each vertex's parent in the BFS tree: source is its own parent and
+    // unreachable vertices have no_vertex. Direction optimizing (Beamer, Asanović and Patterson): levels whose
+    // frontier is small expand it top-down, claiming unvisited neighbors with a compare and swap; once the frontier's
+    // edges outnumber those left to explore by alpha, levels run bottom-up instead, each unvisited vertex scanning its
+    // in-neighbors for one in a frontier bitmap and stopping at the first. in is the transpose of out; the overload
+    // taking one graph is for symmetric ones. Levels run on up to threads threads.
+    template<typename Vertex>
+    std::vector<Vertex> floating_bfs(const floating_csr_graph<Vertex>& out, const floating_csr_graph<Vertex>& in,
+                                     typename floating_csr_graph<Vertex>::vertex_type source,
+                                     unsigned threads = std::thread::hardware_concurrency()) {
+        constexpr Vertex none = floating_csr_graph<Vertex>::no_vertex;
+        constexpr std::size_t alpha = 14; // top-down to bottom-up when frontier edges > unexplored edges / alpha
+        constexpr std::size_t beta = 24; // and back when a shrinking frontier has fewer than n / beta vertices
+        std::size_t n = out.vertex_count();
+        detail::graph_workers workers(detail::graph_threads(threads, n));
+        threads = workers.size();
+        std::unique_ptr<std::atomic<Vertex>[]> parent(new std::atomic<Vertex>[n]);
+        workers.run(n, [&](std::size_t begin, std::size_t end, unsigned) {
+            for(std::size_t v = begin; v < end; v++) {
+                parent[v].store(none, std::memory_order_relaxed);
+            }
+        });
+        parent[source].store(source, std::memory_order_relaxed);
+
+        std::vector<Vertex> frontier{source};
+        std::vector<std::uint64_t> frontier_bits;
+        std::vector<std::uint64_t> next_bits;
+        std::vector<std::vector<Vertex>> found(threads);
+        std::vector<std::size_t> found_count(threads);
+        std::vector<std::size_t> found_edges(threads);
+        std::size_t frontier_size = 1;
+        std::size_t frontier_edges = out.degree(source);
+        std::size_t unexplored_edges = out.edge_count() - frontier_edges;
+        bool bottom_up = false;
+        bool growing = true;
+        while(frontier_size) {
+            if(!bottom_up && frontier_edges > unexplored_edges / alpha) {
+                bottom_up = true;
+                frontier_bits.assign((n + 63) / 64, 0);
+                next_bits.assign((n + 63) / 64, 0);
+                for(Vertex v : frontier) {
+                    frontier_bits[v / 64] |= std::uint64_t(1) << (v % 64);
+                }
+            } else if(bottom_up && !growing && frontier_size < n / beta) {
+                bottom_up = false;
+                frontier.clear();
+                for(std::size_t w = 0; w < frontier_bits.size(); w++) {
+                    for(std::uint64_t bits = frontier_bits[w]; bits; bits &= bits - 1) {
+                        frontier.push_back(Vertex(w * 64 + detail::lowest_bit64(bits)));
+                    }
+                }
+            }
+            std::fill(found_count.begin(), found_count.end(), 0);
+            std::fill(found_edges.begin(), found_edges.end(), 0);
+            if(bottom_up) {
+                workers.run(n, [&](std::size_t begin, std::size_t end, unsigned t) {
+                    std::size_t count = 0;
+                    std::size_t edges = 0;
+                    for(std::size_t v = begin; v < end; v++) {
+                        if(parent[v].load(std::memory_order_relaxed) != none) {
+                            continue;
+                        }
+                        for(Vertex u : in.neighbors(Vertex(v))) {
+                            if((frontier_bits[u / 64] >> (u % 64)) & 1) {
+                                parent[v].store(u, std::memory_order_relaxed);
+                                next_bits[v / 64] |= std::uint64_t(1) << (v % 64);
+                                count++;
+                                edges += out.degree(Vertex(v));
+                                break;
+                            }
+                        }
+                    }
+                    found_count[t] += count;
+                    found_edges[t] += edges;
+                });
+                std::swap(frontier_bits, next_bits);
+                std::fill(next_bits.begin(), next_bits.end(), 0);
+            } else {
+                workers.run(frontier.size(), [&](std::size_t begin, std::size_t end, unsigned t) {
+                    std::size_t edges = 0;
+                    for(std::size_t i = begin; i < end; i++) {
+                        Vertex u = frontier[i];
+                        for(Vertex w : out.neighbors(u)) {
+                            Vertex expected = none;
+                            if(parent[w].load(std::memory_order_relaxed) == none
+                               && parent[w].compare_exchange_strong(expected, u, std::memory_order_relaxed)) {
+                                found[t].push_back(w);
+                                edges += out.degree(w);
+                            }
+                        }
+                    }
+                    found_edges[t] += edges;
+                });
+                frontier.clear();
+                for(unsigned t = 0; t < threads; t++) {
+                    found_count[t] = found[t].size();
+                    frontier.insert(frontier.end(), found[t].begin(), found[t].end());
+                    found[t].clear();
+                }
+            }
+            std::size_t next_size = 0;
+            frontier_edges = 0;
+            for(unsigned t = 0; t < threads; t++) {
+                next_size += found_count[t];
+                frontier_edges += found_edges[t];
+            }
+            growing = next_size > frontier_size;
+            frontier_size = next_size;
+            unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+        }
+
+        std::vector<Vertex> result(n);
+        workers.run(n, [&](std::size_t begin, std::size_t end, unsigned) {
+            for(std::size_t v = begin; v < end; v++) {
+                result[v] = parent[v].load(std::memory_order_relaxed);
+            }
+        });
+        return result;
+    }
+    template<typename Vertex>
+    std::vector<Vertex> floating_bfs(const floating_csr_graph<Vertex>& symmetric,
+                                     typename floating_csr_graph<Vertex>::vertex_type source,
+                                     unsigned threads = std::thread::hardware_concurrency()) {
+        return floating_bfs(symmetric, symmetric, source, threads);
+    }
+
+    // PageRank by power iteration, pulling along in-edges so that each rank is written by one thread and no atomics
+    // are needed. Rank held by vertices without out-edges is spread evenly over all vertices. Returns ranks summing
+    // to 1. in is the transpose of out; the overload taking one graph is for symmetric ones.
+    template<typename Vertex>
+    std::vector<double> floating_pagerank(const floating_csr_graph<Vertex>& out, const floating_csr_graph<Vertex>& in,
+                                          std::size_t iterations = 20, double damping = 0.85,
+                                          unsigned threads = std::thread::hardware_concurrency()) {
+        std::size_t n = out.vertex_count();
+        detail::graph_workers workers(detail::graph_threads(threads, n));
+        threads = workers.size();
+        std::vector<double> rank(n, n ? 1.0 / double(n) : 0.0);
+        std::vector<double> contribution(n);
+        std::vector<double> dangling(threads);
+        for(std::size_t i = 0; i < iterations && n; i++) {
+            std::fill(dangling.begin(), dangling.end(), 0.0);
+            workers.run(n, [&](std::size_t begin, std::size_t end, unsigned t) {
+                double lost = 0;
+                for(std::size_t u = begin; u < end; u++) {
+                    std::size_t degree = out.degree(Vertex(u));
+                    contribution[u] = degree ? rank[u] / double(degree) : 0.0;
+                    lost += degree ? 0.0 : rank[u];
+                }
+                dangling[t] += lost;
+            });
+            double lost = 0;
+            for(double d : dangling) {
+                lost += d;
+            }
+            double base = (1.0 - damping + damping * lost) / double(n);
+            workers.run(n, [&](std::size_t begin, std::size_t end, unsigned) {
+                for(std::size_t v = begin; v < end; v++) {
+                    double sum = 0;
+                    for(Vertex u : in.neighbors(Vertex(v))) {
+                        sum += contribution[u];
+                    }
+                    rank[v] = base + damping * sum;
+                }
+            });
+        }
+        return rank;
+    }
+    template<typename Vertex>
+    std::vector<double> floating_pagerank(const floating_csr_graph<Vertex>& symmetric, std::size_t iterations = 20,
+                                          double damping = 0.85,
+                                          unsigned threads = std::thread::hardware_concurrency()) {
+        return floating_pagerank(symmetric, symmetric, iterations, damping, threads);
+    }
+}
+
+#endif
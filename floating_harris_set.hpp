@@ -0,0 +1,189 @@
+#ifndef FLOATING_HARRIS_SET_HPP
+#define FLOATING_HARRIS_SET_HPP
+
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "floating_atomic.hpp"
+#include "floating_pointers.hpp"
+#include "floating_reclamation.hpp"
+
+namespace based {
+    // A lock-free ordered set: Harris's linked list with Michael's search. Each node's next link is a floating pointer
+    // whose sign bit is the logical deletion mark, so marking the last node turns its null into negativenullptr. Links
+    // are std::atomic floating pointers, whose compare-and-swap works on the raw bits of the double, where -0.0 and 0.0
+    // differ.
+    //
+    // insert, erase and contains are linearizable and may run concurrently from any number of threads. Unlinked nodes
+    // are retired to Reclaimer, floating_epoch_domain or floating_hazard_domain, which frees them once no operation can
+    // still be reading them. Under epochs contains never writes and is wait-free; under hazard pointers a traversal
+    // cannot step through a marked node, so contains helps unlink them like insert and erase do.
+    template<typename K, typename Compare = std::less<K>, typename Reclaimer = floating_epoch_domain>
+    class floating_harris_set {
+        struct node {
+            K key;
+            std::atomic<floating_pointer<node>> next;
+            template<typename... Args>
+            explicit node(Args&&... args) : key(std::forward<Args>(args)...) {}
+        };
+        using link = floating_pointer<node>;
+        using guard = typename Reclaimer::guard;
+
+        // Searches unlink marked nodes, from const members too
+        mutable std::atomic<link> _head;
+        Compare _compare;
+
+        static link load(const std::atomic<link>& a) {
+            return a.load(std::memory_order_acquire);
+        }
+        static bool cas(std::atomic<link>& a, link expected, link desired) {
+            return a.compare_exchange_strong(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire);
+        }
+        static bool same(link a, link b) {
+            return detail::pointer_bits(a) == detail::pointer_bits(b);
+        }
+        bool equal(const K& a, const K& b) const {
+            return !_compare(a, b) && !_compare(b, a);
+        }
+
+        // The first unmarked node not less than key (null key: the end) and the link pointing at it, unlinking marked
+        // nodes on the way and calling visit on each node passed. Hazard slots: 0 next, 1 curr, 2 the node owning prev.
+        template<typename Visit>
+        std::pair<std::atomic<link>*, link> search(const guard& g, const K* key, Visit&& visit) const {
+        retry:
+            std::atomic<link>* prev = &_head;
+            link curr = g.protect(1, *prev);
+            while(curr) {
+                link next = g.protect(0, curr->next);
+                // Under hazard pointers next is only safe if curr was still linked after next was published
+                if(!Reclaimer::protects_traversal && !same(load(*prev), curr)) {
+                    goto retry;
+                }
+                if(signbit(next)) {
+                    // curr is logically deleted; prev fails to swing if it was marked or changed meanwhile
+                    if(!cas(*prev, curr, abs(next))) {
+                        goto retry;
+                    }
+                    Reclaimer::instance().retire(curr);
+                    curr = abs(next);
+                    g.hold(1, curr);
+                    continue;
+                }
+                if(key && !_compare(curr->key, *key)) {
+                    break;
+                }
+                visit(curr);
+                prev = &curr->next;
+                g.hold(2, curr);
+                curr = next;
+                g.hold(1, curr);
+            }
+            return {prev, curr};
+        }
+        std::pair<std::atomic<link>*, link> search(const guard& g, const K& key) const {
+            return search(g, &key, [](link) {});
+        }
+    public:
+        using key_type = K;
+        using value_type = K;
+        using key_compare = Compare;
+        using reclaimer_type = Reclaimer;
+
+        floating_harris_set() = default;
+        explicit floating_harris_set(const Compare& compare) : _compare(compare) {}
+        floating_harris_set(const floating_harris_set&) = delete;
+        floating_harris_set& operator=(const floating_harris_set&) = delete;
+        // Not concurrent with other operations. Nodes already retired are left to the reclaimer.
+        ~floating_harris_set() {
+            link n = load(_head);
+            while(n) {
+                link next = abs(load(n->next));
+                delete static_cast<node*>(n);
+                n = next;
+            }
+        }
+
+        // False when key was already present
+        bool insert(const K& key) {
+            guard g = Reclaimer::instance().pin();
+            link n = nullptr;
+            for(;;) {
+                auto [prev, curr] = search(g, key);
+                if(curr && equal(curr->key, key)) {
+                    delete static_cast<node*>(n);
+                    return false;
+                }
+                if(!n) {
+                    n = new node(key);
+                }
+                n->next.store(curr, std::memory_order_relaxed);
+                if(cas(*prev, curr, n)) {
+                    return true;
+                }
+            }
+        }
+
+        // False when key was absent
+        bool erase(const K& key) {
+            guard g = Reclaimer::instance().pin();
+            for(;;) {
+                auto [prev, curr] = search(g, key);
+                if(!curr || !equal(curr->key, key)) {
+                    return false;
+                }
+                link next = load(curr->next);
+                if(signbit(next) || !cas(curr->next, next, -next)) {
+                    continue;
+                }
+                // Marked, so the erase has taken effect; unlink now or leave it to the next search
+                if(cas(*prev, curr, next)) {
+                    Reclaimer::instance().retire(curr);
+                } else {
+                    search(g, key);
+                }
+                return true;
+            }
+        }
+
+        bool contains(const K& key) const {
+            guard g = Reclaimer::instance().pin();
+            if constexpr(Reclaimer::protects_traversal) {
+                // Walks past marked nodes without helping to unlink them
+                link curr = load(_head);
+                while(curr && _compare(curr->key, key)) {
+                    curr = abs(load(curr->next));
+                }
+                return curr && equal(curr->key, key) && !signbit(load(curr->next));
+            } else {
+                link curr = search(g, key).second;
+                return curr && equal(curr->key, key);
+            }
+        }
+
+        // Calls f(key) for each key present in order. Concurrent updates may or may not be seen.
+        template<typename F>
+        void for_each(F&& f) const {
+            guard g = Reclaimer::instance().pin();
+            if constexpr(Reclaimer::protects_traversal) {
+                for(link curr = load(_head); curr; curr = abs(load(curr->next))) {
+                    if(!signbit(load(curr->next))) {
+                        f(static_cast<const K&>(curr->key));
+                    }
+                }
+            } else {
+                // A search restarts from the head when it loses a race, so skip keys already passed
+                std::optional<K> last;
+                search(g, nullptr, [&](link curr) {
+                    if(!last || _compare(*last, curr->key)) {
+                        f(static_cast<const K&>(curr->key));
+                        last = curr->key;
+                    }
+                });
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef FLOATING_HEAP_HPP
+#define FLOATING_HEAP_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        // A free block. Free lists are threaded through the blocks themselves: next links blocks within a batch and
+        // next_batch links the first blocks of the batches parked on a central list.
+        struct heap_block {
+            floating_pointer<heap_block> next;
+            floating_pointer<heap_block> next_batch;
+        };
+    }
+
+    // A general purpose allocator for many threads handing out floating pointers, in the style of tcmalloc. Small
+    // requests are rounded up to a size class and served from a per-thread cache without locking. Caches exchange
+    // whole batches of blocks with a per-class central free list, so the lock is taken once per batch rather than once
+    // per allocation. Blocks may be freed from any thread. Requests above max_small_size or with an alignment above
+    // 16 bytes go straight to the upstream resource.
+    //
+    // Memory carved for small blocks is kept for reuse and never returned upstream. There is one process-wide heap,
+    // floating_heap::instance(); it is also a std::pmr::memory_resource and can back a floating_allocator.
+    class floating_heap : public std::pmr::memory_resource {
+    public:
+        static constexpr std::size_t max_small_size = 1024;
+        static constexpr std::size_t alignment = 16;
+    private:
+        using block = detail::heap_block;
+        static constexpr std::size_t class_count = 22;
+        static constexpr std::size_t span_size = 64 * 1024;
+
+        // 16 byte steps up to 256, then 128 byte steps up to 1024
+        static constexpr std::size_t size_class(std::size_t bytes) {
+            return bytes <= 256 ? (bytes ? (bytes - 1) / 16 : 0) : 16 + (bytes - 257) / 128;
+        }
+        static constexpr std::size_t class_size(std::size_t c) {
+            return c < 16 ? (c + 1) * 16 : 256 + (c - 15) * 128;
+        }
+        static constexpr std::size_t batch_size(std::size_t c) {
+            std::size_t n = 8 * 1024 / class_size(c);
+            return n < 4 ? 4 : n > 64 ? 64 : n;
+        }
+
+        struct central_list {
+            std::mutex lock;
+            floating_pointer<block> batches = nullptr;
+        };
+        central_list _central[class_count];
+        std::pmr::memory_resource* _upstream;
+
+        struct thread_cache {
+            floating_pointer<block> heads[class_count] = {};
+            std::size_t counts[class_count] = {};
+            floating_heap* heap;
+            explicit thread_cache(floating_heap* heap) : heap(heap) {}
+            thread_cache(const thread_cache&) = delete;
+            thread_cache& operator=(const thread_cache&) = delete;
+            // Hands everything back to the central lists when the thread exits
+            ~thread_cache() {
+                for(std::size_t c = 0; c < class_count; c++) {
+                    while(counts[c]) {
+                        heap->release_batch(*this, c, counts[c] < batch_size(c) ? counts[c] : batch_size(c));
+                    }
+                }
+            }
+        };
+
+        // Set when the calling thread's cache is destroyed. A bool has no destructor, so it stays readable from the
+        // thread_local and static destructors that run after the cache's.
+        static bool& cache_destroyed() {
+            static thread_local bool destroyed = false;
+            return destroyed;
+        }
+        // The calling thread's cache, or null once it has been destroyed
+        thread_cache* cache() {
+            if(cache_destroyed()) {
+                return nullptr;
+            }
+            static thread_local struct owner {
+                thread_cache tc;
+                explicit owner(floating_heap* heap) : tc(heap) {}
+                ~owner() {
+                    cache_destroyed() = true;
+                }
+            } local(this);
+            return &local.tc;
+        }
+
+        // Moves the first n blocks of the thread's list for class c to the central list
+        void release_batch(thread_cache& tc, std::size_t c, std::size_t n) {
+            floating_pointer<block> first = tc.heads[c];
+            floating_pointer<block> last = first;
+            for(std::size_t i = 1; i < n; i++) {
+                last = last->next;
+            }
+            tc.heads[c] = last->next;
+            tc.counts[c] -= n;
+            last->next = nullptr;
+            std::lock_guard<std::mutex> guard(_central[c].lock);
+            first->next_batch = _central[c].batches;
+            _central[c].batches = first;
+        }
+
+        // Takes a batch from the central list, or carves a fresh span when the central list is empty. Batches are
+        // usually batch_size(c) long but exiting threads may park shorter ones, so the batch is counted.
+        void refill(thread_cache& tc, std::size_t c) {
+            floating_pointer<block> batch;
+            {
+                std::lock_guard<std::mutex> guard(_central[c].lock);
+                batch = _central[c].batches;
+                if(batch) {
+                    _central[c].batches = batch->next_batch;
+                }
+            }
+            if(batch) {
+                std::size_t n = 0;
+                for(floating_pointer<block> b = batch; b; b = b->next) {
+                    n++;
+                }
+                tc.heads[c] = batch;
+                tc.counts[c] = n;
+                return;
+            }
+            std::size_t size = class_size(c);
+            std::size_t n = span_size / size;
+            auto span = static_cast<unsigned char*>(_upstream->allocate(span_size, alignment));
+            floating_pointer<block> head = nullptr;
+            for(std::size_t i = n; i-- > 0;) {
+                floating_pointer<block> b = ::new(static_cast<void*>(span + i * size)) block{head, nullptr};
+                head = b;
+            }
+            tc.heads[c] = head;
+            tc.counts[c] = n;
+        }
+
+        void* allocate_small(thread_cache& tc, std::size_t c) {
+            if(!tc.heads[c]) {
+                refill(tc, c);
+            }
+            floating_pointer<block> b = tc.heads[c];
+            tc.heads[c] = b->next;
+            tc.counts[c]--;
+            return static_cast<block*>(b);
+        }
+        void deallocate_small(thread_cache& tc, void* p, std::size_t c) {
+            floating_pointer<block> b = ::new(p) block{tc.heads[c], nullptr};
+            tc.heads[c] = b;
+            if(++tc.counts[c] >= 2 * batch_size(c)) {
+                release_batch(tc, c, batch_size(c));
+            }
+        }
+
+        floating_heap() : _upstream(std::pmr::new_delete_resource()) {}
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t align) override {
+            if(bytes > max_small_size || align > alignment) {
+                return _upstream->allocate(bytes, align);
+            }
+            std::size_t c = size_class(bytes);
+            if(thread_cache* tc = cache()) {
+                return allocate_small(*tc, c);
+            }
+            // The thread's cache is gone, as in static destructors; a temporary one parks what is left of the batch
+            // it takes on the central list again
+            thread_cache temporary(this);
+            return allocate_small(temporary, c);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+            if(bytes > max_small_size || align > alignment) {
+                _upstream->deallocate(p, bytes, align);
+                return;
+            }
+            std::size_t c = size_class(bytes);
+            if(thread_cache* tc = cache()) {
+                deallocate_small(*tc, p, c);
+                return;
+            }
+            thread_cache temporary(this);
+            deallocate_small(temporary, p, c);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    public:
+        floating_heap(const floating_heap&) = delete;
+        floating_heap& operator=(const floating_heap&) = delete;
+        // Never destroyed, so blocks may still be allocated and freed from static destructors and exiting threads;
+        // once a thread's cache is gone its requests go through the central lists
+        static floating_heap& instance() {
+            static floating_heap* heap = new floating_heap();
+            return *heap;
+        }
+        template<typename T, typename... Args>
+        floating_pointer<T> make(Args&&... args) {
+            return floating_pointer<T>(::new(do_allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+        }
+        template<typename T>
+        void destroy(floating_pointer<T> ptr) {
+            T* object = ptr;
+            object->~T();
+            do_deallocate(const_cast<typename std::remove_cv<T>::type*>(object), sizeof(T), alignof(T));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef FLOATING_IMPLICIT_TREE_HPP
+#define FLOATING_IMPLICIT_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    enum class implicit_layout {
+        eytzinger, // breadth first: children of slot i at 2i and 2i + 1
+        van_emde_boas // recursively split into top and bottom trees of half the height: cache-oblivious
+    };
+
+    namespace detail {
+        inline void prefetch(const void* address) {
+            #if defined(__GNUC__)
+            __builtin_prefetch(address);
+            #else
+            (void)address;
+            #endif
+        }
+        inline unsigned trailing_ones(std::uint64_t x) {
+            #if defined(__GNUC__)
+            return unsigned(__builtin_ctzll(~x));
+            #else
+            unsigned i = 0;
+            while(x & 1) {
+                x >>= 1;
+                i++;
+            }
+            return i;
+            #endif
+        }
+    }
+
+    // A read-only search tree with no child pointers: a copy of a binary search tree (or any sorted sequence) whose
+    // keys are laid out so a lookup computes each child's slot instead of loading it. Keys and values live in separate
+    // arrays so descents touch keys only.
+    //
+    // eytzinger stores the tree breadth first. The top levels share a few cache lines and the search prefetches the
+    // line holding the next four or so levels while comparing, which hides most of the latency of the deep levels.
+    // van_emde_boas pads the tree to a complete one with copies of the largest element and stores it recursively: the
+    // top half of the levels, then each bottom subtree, each itself split the same way. Every root-to-leaf path then
+    // crosses O(log_B n) blocks of any block size B, cache lines and pages alike; per-depth tables computed at build
+    // time turn the breadth first index of each node on the path into its slot (Brodal, Fagerberg and Jacob).
+    //
+    // Both searches are branch-free apart from the loop over the levels: each comparison picks the child by index
+    // arithmetic and the last node passed to the right of is tracked with a conditional move. K needs operator<.
+    template<typename K, typename V>
+    class floating_implicit_tree {
+        implicit_layout _layout = implicit_layout::eytzinger;
+        std::size_t _size = 0;
+        std::vector<K> _keys; // eytzinger: slots 1 to size; van_emde_boas: 2^height - 1 slots
+        std::vector<V> _values;
+        // van_emde_boas only: tree height and, per depth, top tree size, bottom tree size and the top tree root depth
+        unsigned _height = 0;
+        std::vector<std::size_t> _top;
+        std::vector<std::size_t> _bottom;
+        std::vector<unsigned> _top_depth;
+
+        static constexpr std::size_t prefetch_stride = sizeof(K) >= 64 ? 1 : 64 / sizeof(K);
+
+        // Places sorted[rank...] in order into the eytzinger slots below i, returning the next rank
+        std::size_t fill_eytzinger(std::vector<std::pair<K, V>>& sorted, std::vector<std::pair<K, V>*>& slots,
+                                   std::size_t i, std::size_t rank) {
+            if(i < slots.size()) {
+                rank = fill_eytzinger(sorted, slots, 2 * i, rank);
+                slots[i] = &sorted[rank++];
+                rank = fill_eytzinger(sorted, slots, 2 * i + 1, rank);
+            }
+            return rank;
+        }
+        // Emits the subtree of breadth first index root and height h in van Emde Boas order
+        void emit_veb(const std::vector<std::pair<K, V>*>& bfs, std::size_t root, unsigned h) {
+            if(h == 1) {
+                _keys.push_back(bfs[root]->first);
+                _values.push_back(bfs[root]->second);
+                return;
+            }
+            unsigned top = h / 2;
+            emit_veb(bfs, root, top);
+            for(std::size_t j = 0; j < (std::size_t(1) << top); j++) {
+                emit_veb(bfs, (root << top) + j, h - top);
+            }
+        }
+        // Records, for the depth at which each bottom tree is rooted, the split that created it
+        void split_veb(unsigned depth, unsigned h) {
+            if(h == 1) {
+                return;
+            }
+            unsigned top = h / 2;
+            _top[depth + top] = (std::size_t(1) << top) - 1;
+            _bottom[depth + top] = (std::size_t(1) << (h - top)) - 1;
+            _top_depth[depth + top] = depth;
+            split_veb(depth, top);
+            split_veb(depth + top, h - top);
+        }
+
+        // The slot of the first key not less than key, or none
+        std::size_t lower_bound_eytzinger(const K& key, std::size_t none) const {
+            const K* keys = _keys.data();
+            std::size_t i = 1;
+            while(i <= _size) {
+                // Addresses past the end are fine to prefetch but not to form as pointers
+                std::uintptr_t ahead = std::uintptr_t(keys) + i * prefetch_stride * sizeof(K);
+                detail::prefetch(reinterpret_cast<const void*>(ahead));
+                i = 2 * i + (keys[i] < key);
+            }
+            // Undo the right turns taken since the last left turn
+            i >>= detail::trailing_ones(i) + 1;
+            return i ? i : none;
+        }
+        std::size_t lower_bound_veb(const K& key, std::size_t none) const {
+            std::size_t position[64];
+            std::size_t result = none;
+            std::size_t i = 1;
+            for(unsigned d = 0; d < _height; d++) {
+                std::size_t p = d == 0 ? 0 : position[_top_depth[d]] + _top[d] + (i & _top[d]) * _bottom[d];
+                position[d] = p;
+                bool right = _keys[p] < key;
+                result = right ? result : p;
+                i = 2 * i + right;
+            }
+            return result;
+        }
+        std::size_t lower_bound_slot(const K& key, std::size_t none) const {
+            if(_layout == implicit_layout::eytzinger) {
+                return lower_bound_eytzinger(key, none);
+            }
+            return lower_bound_veb(key, none);
+        }
+
+        void build(std::vector<std::pair<K, V>> sorted) {
+            _size = sorted.size();
+            if(_layout == implicit_layout::eytzinger) {
+                std::vector<std::pair<K, V>*> slots(_size + 1);
+                fill_eytzinger(sorted, slots, 1, 0);
+                // Slot 0 is unused; fill it with any element so K and V need not be default constructible
+                if(_size) {
+                    slots[0] = slots[1];
+                }
+                for(auto* s : slots) {
+                    if(s) {
+                        _keys.push_back(s->first);
+                        _values.push_back(s->second);
+                    }
+                }
+                return;
+            }
+            if(!_size) {
+                return;
+            }
+            while((std::size_t(1) << _height) - 1 < _size) {
+                _height++;
+            }
+            std::size_t complete = (std::size_t(1) << _height) - 1;
+            std::pair<K, V> largest = sorted.back();
+            sorted.resize(complete, largest);
+            std::vector<std::pair<K, V>*> bfs(complete + 1);
+            fill_eytzinger(sorted, bfs, 1, 0);
+            _keys.reserve(complete);
+            _values.reserve(complete);
+            emit_veb(bfs, 1, _height);
+            _top.assign(_height, 0);
+            _bottom.assign(_height, 0);
+            _top_depth.assign(_height, 0);
+            split_veb(0, _height);
+        }
+    public:
+        using key_type = K;
+        using mapped_type = V;
+
+        floating_implicit_tree() = default;
+        // From (key, value) pairs sorted by key
+        floating_implicit_tree(std::vector<std::pair<K, V>> sorted, implicit_layout layout) : _layout(layout) {
+            build(std::move(sorted));
+        }
+        // Copies a binary search tree of nodes with floating_pointer<Node> left and right members; key(const Node&)
+        // and value(const Node&) extract each node's entry. The source is walked in order and not modified.
+        template<typename Node, typename Key, typename Value>
+        static floating_implicit_tree from_tree(floating_pointer<Node> root, Key key, Value value,
+                                                implicit_layout layout) {
+            std::vector<std::pair<K, V>> sorted;
+            std::vector<floating_pointer<Node>> stack;
+            floating_pointer<Node> n = root;
+            while(n || !stack.empty()) {
+                while(n) {
+                    stack.push_back(n);
+                    n = n->left;
+                }
+                n = stack.back();
+                stack.pop_back();
+                sorted.emplace_back(key(*n), value(*n));
+                n = n->right;
+            }
+            return floating_implicit_tree(std::move(sorted), layout);
+        }
+
+        // The value for key, or null
+        const V* find(const K& key) const {
+            std::size_t none = _keys.size();
+            std::size_t slot = lower_bound_slot(key, none);
+            if(slot == none || key < _keys[slot]) {
+                return nullptr;
+            }
+            return &_values[slot];
+        }
+        bool contains(const K& key) const {
+            return find(key) != nullptr;
+        }
+        // The entry with the smallest key not less than key, or null pointers when there is none
+        std::pair<const K*, const V*> lower_bound(const K& key) const {
+            std::size_t none = _keys.size();
+            std::size_t slot = lower_bound_slot(key, none);
+            if(slot == none) {
+                return {nullptr, nullptr};
+            }
+            return {&_keys[slot], &_values[slot]};
+        }
+        std::size_t size() const {
+            return _size;
+        }
+        bool empty() const {
+            return _size == 0;
+        }
+        implicit_layout layout() const {
+            return _layout;
+        }
+        // Bytes of key storage, padding included
+        std::size_t key_bytes() const {
+            return _keys.size() * sizeof(K);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef FLOATING_MS_QUEUE_HPP
+#define FLOATING_MS_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "floating_pointers.hpp"
+#include "floating_treiber_stack.hpp"
+
+namespace based {
+    // A bounded lock-free multi-producer multi-consumer FIFO queue (Michael and Scott's). Head, tail and every node's
+    // next link are NaN-boxed node indices with ABA versions, swapped with ordinary 64 bit compare-and-swap. Nodes come
+    // from a pool fixed at construction, one of which is the queue's dummy node; push fails when it is exhausted.
+    //
+    // As in the original algorithm a consumer copies the value out before it knows its swap succeeded, so T must be
+    // trivially copyable, as with boost::lockfree.
+    template<typename T>
+    class floating_ms_queue {
+        static_assert(std::is_trivially_copyable<T>::value, "floating_ms_queue needs a trivially copyable T");
+        using tagged_index = detail::tagged_index;
+        detail::index_pool<T> _pool;
+        alignas(64) std::atomic<tagged_index> _head{tagged_index()};
+        alignas(64) std::atomic<tagged_index> _tail{tagged_index()};
+    public:
+        using value_type = T;
+        // capacity elements plus the dummy node must fit below 2^26 - 1
+        explicit floating_ms_queue(std::size_t capacity)
+            : _pool(capacity < tagged_index::null ? capacity + 1 : tagged_index::null) {
+            std::uint32_t dummy = _pool.allocate();
+            _pool[dummy].next.store(tagged_index(tagged_index::null, 0), std::memory_order_relaxed);
+            _head.store(tagged_index(dummy, 0), std::memory_order_relaxed);
+            _tail.store(tagged_index(dummy, 0), std::memory_order_relaxed);
+        }
+        floating_ms_queue(const floating_ms_queue&) = delete;
+        floating_ms_queue& operator=(const floating_ms_queue&) = delete;
+
+        // False when full
+        bool push(const T& value) {
+            std::uint32_t index = _pool.allocate();
+            if(index == tagged_index::null) {
+                return false;
+            }
+            auto& n = _pool[index];
+            n.value = value;
+            // Keep the link's version climbing across reuses of the node
+            n.next.store(n.next.load(std::memory_order_relaxed).next(tagged_index::null), std::memory_order_relaxed);
+            for(;;) {
+                tagged_index tail = _tail.load(std::memory_order_acquire);
+                tagged_index next = _pool[tail.index()].next.load(std::memory_order_acquire);
+                if(tail != _tail.load(std::memory_order_acquire)) {
+                    continue;
+                }
+                if(next.index() == tagged_index::null) {
+                    if(_pool[tail.index()].next.compare_exchange_weak(next, next.next(index), std::memory_order_release,
+                                                                      std::memory_order_relaxed)) {
+                        _tail.compare_exchange_strong(tail, tail.next(index), std::memory_order_release,
+                                                      std::memory_order_relaxed);
+                        return true;
+                    }
+                } else {
+                    // The tail lags behind; help it along
+                    _tail.compare_exchange_weak(tail, tail.next(next.index()), std::memory_order_release,
+                                                std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // False when empty
+        bool pop(T& value) {
+            for(;;) {
+                tagged_index head = _head.load(std::memory_order_acquire);
+                tagged_index tail = _tail.load(std::memory_order_acquire);
+                tagged_index next = _pool[head.index()].next.load(std::memory_order_acquire);
+                if(head != _head.load(std::memory_order_acquire)) {
+                    continue;
+                }
+                if(head.index() == tail.index()) {
+                    if(next.index() == tagged_index::null) {
+                        return false;
+                    }
+                    _tail.compare_exchange_weak(tail, tail.next(next.index()), std::memory_order_release,
+                                                std::memory_order_relaxed);
+                    continue;
+                }
+                // Read before the swap: afterwards the node may be recycled by another consumer
+                T copy = _pool[next.index()].value;
+                if(_head.compare_exchange_weak(head, head.next(next.index()), std::memory_order_acq_rel,
+                                               std::memory_order_relaxed)) {
+                    value = copy;
+                    _pool.deallocate(head.index());
+                    return true;
+                }
+            }
+        }
+
+        // A snapshot, possibly stale by the time it returns
+        bool empty() const {
+            tagged_index head = _head.load(std::memory_order_acquire);
+            return _pool[head.index()].next.load(std::memory_order_acquire).index() == tagged_index::null;
+        }
+        std::size_t capacity() const {
+            return _pool.capacity() - 1;
+        }
+    };
+}
+
+#endif
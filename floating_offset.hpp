@@ -0,0 +1,120 @@
+#ifndef FLOATING_OFFSET_HPP
+#define FLOATING_OFFSET_HPP
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        template<typename Repr> struct offset_digits {
+            static constexpr int value = std::numeric_limits<Repr>::digits;
+        };
+        #ifdef __FLT16_MANT_DIG__
+        template<> struct offset_digits<_Float16> {
+            static constexpr int value = __FLT16_MANT_DIG__;
+        };
+        #endif
+    }
+
+    // A compact pointer: an element offset from a per-pool base, stored in a narrow floating type. With float an
+    // offset is 4 bytes and addresses 2^24 elements exactly; with _Float16 it is 2 bytes and addresses 2^11. The null
+    // offset is a NaN. Resolving needs the base, usually through a floating_offset_pool.
+    template<typename T, typename Repr = float>
+    class floating_offset {
+        Repr _offset;
+    public:
+        static constexpr std::size_t max_elements = std::size_t(1) << detail::offset_digits<Repr>::value;
+    private:
+        // Past max_elements Repr rounds and the offset would alias another element
+        static constexpr Repr checked(std::size_t index) {
+            return index < max_elements ? Repr(index)
+                                        : throw std::length_error("floating_offset index exceeds max_elements");
+        }
+    public:
+        constexpr floating_offset() = default;
+        constexpr floating_offset(std::nullptr_t) : _offset(Repr(NAN)) {}
+        constexpr floating_offset(nanptr_t) : _offset(Repr(NAN)) {}
+        // Throws std::length_error unless the index is below max_elements; pointers before base count as too far
+        explicit constexpr floating_offset(std::size_t index) : _offset(checked(index)) {}
+        constexpr floating_offset(floating_pointer<T> base, floating_pointer<T> ptr)
+            : _offset(ptr ? checked(std::size_t(ptr - base)) : Repr(NAN)) {}
+        explicit constexpr operator bool() const {
+            return _offset == _offset;
+        }
+        constexpr std::size_t index() const {
+            return std::size_t(_offset);
+        }
+        constexpr floating_pointer<T> resolve(floating_pointer<T> base) const {
+            return *this ? base + double(_offset) : floating_pointer<T>(nullptr);
+        }
+        // All null offsets are equal
+        constexpr bool operator==(floating_offset other) const {
+            return _offset == other._offset || (!*this && !other);
+        }
+        constexpr bool operator!=(floating_offset other) const {
+            return !(*this == other);
+        }
+    };
+
+    // Owns the elements that floating_offsets point into. Offsets stay valid when the pool grows and moves, unlike
+    // pointers into it.
+    template<typename T, typename Repr = float>
+    class floating_offset_pool {
+        std::vector<T> _elements;
+    public:
+        using offset = floating_offset<T, Repr>;
+        static constexpr std::size_t max_elements = offset::max_elements;
+        floating_offset_pool() = default;
+        explicit floating_offset_pool(std::size_t capacity) {
+            _elements.reserve(capacity);
+        }
+        // Throws std::length_error, adding nothing, when the pool already holds max_elements elements
+        template<typename... Args>
+        offset make(Args&&... args) {
+            if(_elements.size() >= max_elements) {
+                throw std::length_error("floating_offset_pool is full");
+            }
+            _elements.emplace_back(std::forward<Args>(args)...);
+            return offset(_elements.size() - 1);
+        }
+        floating_pointer<T> base() {
+            return _elements.data();
+        }
+        floating_pointer<T> resolve(offset o) {
+            return o.resolve(base());
+        }
+        floating_pointer<const T> resolve(offset o) const {
+            return o.resolve(const_cast<T*>(_elements.data()));
+        }
+        // o must not be null: a NaN has no index
+        T& operator[](offset o) {
+            assert(o);
+            return _elements[o.index()];
+        }
+        const T& operator[](offset o) const {
+            assert(o);
+            return _elements[o.index()];
+        }
+        offset offset_of(floating_pointer<T> ptr) {
+            return offset(base(), ptr);
+        }
+        std::size_t size() const {
+            return _elements.size();
+        }
+        void reserve(std::size_t n) {
+            _elements.reserve(n);
+        }
+        void clear() {
+            _elements.clear();
+        }
+    };
+}
+
+#endif
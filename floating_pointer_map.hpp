@@ -0,0 +1,410 @@
+#ifndef FLOATING_POINTER_MAP_HPP
+#define FLOATING_POINTER_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+ #include <emmintrin.h>
+#endif
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        // Control bytes of an open-addressing table: the top bit marks a free slot, a full slot holds the low 7 bits
+        // of its key's hash
+        constexpr std::int8_t ctrl_empty = -128;
+        constexpr std::int8_t ctrl_deleted = -2;
+
+        inline unsigned lowest_bit(std::uint32_t mask) {
+            #if defined(__GNUC__)
+            return unsigned(__builtin_ctz(mask));
+            #else
+            unsigned i = 0;
+            while(!(mask & 1)) {
+                mask >>= 1;
+                i++;
+            }
+            return i;
+            #endif
+        }
+
+        // Sixteen control bytes matched at once, one result bit per byte: SSE2 compares where available, otherwise
+        // the same on two 64 bit words. The portable match() may report false positives after a true match, which the
+        // key comparison that follows weeds out; the free and empty matches are exact.
+        class ctrl_group {
+            #ifdef __SSE2__
+            __m128i _bytes;
+            #else
+            std::uint64_t _words[2];
+            static constexpr std::uint64_t lsbs = 0x0101010101010101;
+            static constexpr std::uint64_t msbs = 0x8080808080808080;
+            // One bit per byte from the top bit of each byte
+            static std::uint32_t gather(std::uint64_t low, std::uint64_t high) {
+                return std::uint32_t((((low & msbs) >> 7) * 0x0102040810204080) >> 56)
+                       | std::uint32_t((((high & msbs) >> 7) * 0x0102040810204080) >> 56) << 8;
+            }
+            #endif
+        public:
+            static constexpr std::size_t width = 16;
+            explicit ctrl_group(const std::int8_t* ctrl) {
+                #ifdef __SSE2__
+                _bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+                #else
+                std::memcpy(_words, ctrl, sizeof(_words));
+                #endif
+            }
+            std::uint32_t match(std::int8_t h2) const {
+                #ifdef __SSE2__
+                return std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_bytes, _mm_set1_epi8(h2))));
+                #else
+                std::uint64_t pattern = lsbs * std::uint8_t(h2);
+                std::uint64_t low = _words[0] ^ pattern;
+                std::uint64_t high = _words[1] ^ pattern;
+                return gather((low - lsbs) & ~low, (high - lsbs) & ~high);
+                #endif
+            }
+            std::uint32_t match_empty() const {
+                #ifdef __SSE2__
+                return match(ctrl_empty);
+                #else
+                // Of the control bytes only empty has its top bit set and bit 1 clear
+                return gather(_words[0] & ~(_words[0] << 6), _words[1] & ~(_words[1] << 6));
+                #endif
+            }
+            // Empty or deleted
+            std::uint32_t match_free() const {
+                #ifdef __SSE2__
+                return std::uint32_t(_mm_movemask_epi8(_bytes));
+                #else
+                return gather(_words[0], _words[1]);
+                #endif
+            }
+        };
+    }
+
+    // An open-addressing hash map keyed by floating pointers, for pointer -> metadata tables. Slots are laid out in
+    // groups of sixteen with a control byte each holding seven bits of the key's hash, and a lookup compares a whole
+    // group's control bytes at once (SSE2, or SWAR without it) before touching any key, so most misses and hits read
+    // one cache line of control bytes and at most one slot. Groups are probed triangularly; the table grows at 7/8
+    // occupancy. There are no nodes: elements live in the slot array and move when it grows, which invalidates
+    // iterators and references. Erasing invalidates only the erased element.
+    //
+    // Keys are canonicalized before hashing and comparison: negativenullptr is nullptr and every NaN pointer is
+    // nanptr, so unlike under == a NaN key is found again. Other keys, tagged ones included, compare by bit pattern.
+    template<typename T, typename V>
+    class floating_pointer_map {
+    public:
+        using key_type = floating_pointer<T>;
+        using mapped_type = V;
+        using value_type = std::pair<const key_type, V>;
+        using size_type = std::size_t;
+        using hasher = std::hash<key_type>;
+    private:
+        using group = detail::ctrl_group;
+        static constexpr std::size_t width = group::width;
+        struct slot {
+            alignas(value_type) unsigned char storage[sizeof(value_type)];
+            value_type& get() {
+                return *std::launder(reinterpret_cast<value_type*>(storage));
+            }
+            const value_type& get() const {
+                return *std::launder(reinterpret_cast<const value_type*>(storage));
+            }
+        };
+
+        std::unique_ptr<std::int8_t[]> _ctrl;
+        std::unique_ptr<slot[]> _slots;
+        std::size_t _capacity = 0; // 0 or a power of two of at least width
+        std::size_t _size = 0;
+        std::size_t _growth_left = 0; // empty slots that may still be filled before the table must grow
+
+        static key_type canonical(key_type key) {
+            if(key == nullptr) {
+                return nullptr;
+            }
+            if(key != key) {
+                return nanptr;
+            }
+            return key;
+        }
+        static std::size_t max_load(std::size_t capacity) {
+            return capacity - capacity / 8;
+        }
+        static std::int8_t h2(std::uint64_t hash) {
+            return std::int8_t(hash & 0x7f);
+        }
+        bool is_full(std::size_t i) const {
+            return _ctrl[i] >= 0;
+        }
+
+        // The slot holding key, or _capacity
+        std::size_t find_index(key_type key) const {
+            if(!_capacity) {
+                return _capacity;
+            }
+            key = canonical(key);
+            std::uint64_t hash = hasher()(key);
+            std::uint64_t bits = detail::pointer_bits(key);
+            std::size_t mask = _capacity / width - 1;
+            std::size_t g = (hash >> 7) & mask;
+            for(std::size_t step = 1;; step++) {
+                group grp(&_ctrl[g * width]);
+                for(std::uint32_t m = grp.match(h2(hash)); m; m &= m - 1) {
+                    std::size_t i = g * width + detail::lowest_bit(m);
+                    if(detail::pointer_bits(_slots[i].get().first) == bits) {
+                        return i;
+                    }
+                }
+                if(grp.match_empty()) {
+                    return _capacity;
+                }
+                g = (g + step) & mask;
+            }
+        }
+        // The first free slot on hash's probe sequence; the table must have one
+        std::size_t find_free(std::uint64_t hash) const {
+            std::size_t mask = _capacity / width - 1;
+            std::size_t g = (hash >> 7) & mask;
+            for(std::size_t step = 1;; step++) {
+                if(std::uint32_t m = group(&_ctrl[g * width]).match_free()) {
+                    return g * width + detail::lowest_bit(m);
+                }
+                g = (g + step) & mask;
+            }
+        }
+        void rehash(std::size_t capacity) {
+            std::unique_ptr<std::int8_t[]> ctrl(new std::int8_t[capacity]);
+            std::unique_ptr<slot[]> slots(new slot[capacity]);
+            std::memset(ctrl.get(), detail::ctrl_empty, capacity);
+            std::swap(_ctrl, ctrl);
+            std::swap(_slots, slots);
+            std::size_t old_capacity = std::exchange(_capacity, capacity);
+            for(std::size_t i = 0; i < old_capacity; i++) {
+                if(ctrl[i] >= 0) {
+                    value_type& v = slots[i].get();
+                    std::uint64_t hash = hasher()(v.first);
+                    std::size_t j = find_free(hash);
+                    _ctrl[j] = h2(hash);
+                    ::new(static_cast<void*>(_slots[j].storage)) value_type(v.first, std::move(v.second));
+                    v.~value_type();
+                }
+            }
+            _growth_left = max_load(_capacity) - _size;
+        }
+        // Out of empty slots: clean up tombstones at the same size if they are most of the load, else grow
+        void make_room() {
+            rehash(_size < max_load(_capacity) / 2 ? _capacity : 2 * _capacity);
+        }
+        void destroy() {
+            for(std::size_t i = 0; i < _capacity; i++) {
+                if(is_full(i)) {
+                    _slots[i].get().~value_type();
+                }
+            }
+        }
+
+        template<typename Value>
+        class basic_iterator {
+            using map_pointer = typename std::conditional<std::is_const<Value>::value, const floating_pointer_map*,
+                                                          floating_pointer_map*>::type;
+            map_pointer _map = nullptr;
+            std::size_t _index = 0;
+            friend class floating_pointer_map;
+            template<typename> friend class basic_iterator;
+            basic_iterator(map_pointer map, std::size_t index) : _map(map), _index(index) {}
+            void skip_free() {
+                while(_index < _map->_capacity && !_map->is_full(_index)) {
+                    _index++;
+                }
+            }
+        public:
+            using value_type = floating_pointer_map::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Value*;
+            using reference = Value&;
+            using iterator_category = std::forward_iterator_tag;
+            basic_iterator() = default;
+            // iterator -> const_iterator
+            template<typename U, typename std::enable_if<std::is_convertible<U*, Value*>::value, int>::type = 0>
+            basic_iterator(basic_iterator<U> other) : _map(other._map), _index(other._index) {}
+            reference operator*() const {
+                return _map->_slots[_index].get();
+            }
+            pointer operator->() const {
+                return &_map->_slots[_index].get();
+            }
+            basic_iterator& operator++() {
+                _index++;
+                skip_free();
+                return *this;
+            }
+            basic_iterator operator++(int) {
+                basic_iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+            friend bool operator==(basic_iterator a, basic_iterator b) {
+                return a._index == b._index;
+            }
+            friend bool operator!=(basic_iterator a, basic_iterator b) {
+                return a._index != b._index;
+            }
+        };
+    public:
+        using iterator = basic_iterator<value_type>;
+        using const_iterator = basic_iterator<const value_type>;
+
+        floating_pointer_map() = default;
+        floating_pointer_map(const floating_pointer_map& other) {
+            reserve(other._size);
+            for(const value_type& v : other) {
+                try_emplace(v.first, v.second);
+            }
+        }
+        floating_pointer_map(floating_pointer_map&& other) noexcept
+            : _ctrl(std::move(other._ctrl)), _slots(std::move(other._slots)),
+              _capacity(std::exchange(other._capacity, 0)), _size(std::exchange(other._size, 0)),
+              _growth_left(std::exchange(other._growth_left, 0)) {}
+        floating_pointer_map& operator=(floating_pointer_map other) noexcept {
+            std::swap(_ctrl, other._ctrl);
+            std::swap(_slots, other._slots);
+            std::swap(_capacity, other._capacity);
+            std::swap(_size, other._size);
+            std::swap(_growth_left, other._growth_left);
+            return *this;
+        }
+        ~floating_pointer_map() {
+            destroy();
+        }
+
+        // Constructs V from args unless key is already present, like std::unordered_map::try_emplace
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type key, Args&&... args) {
+            std::size_t found = find_index(key);
+            if(found != _capacity) {
+                return {iterator(this, found), false};
+            }
+            if(!_capacity) {
+                rehash(width);
+            }
+            key = canonical(key);
+            std::uint64_t hash = hasher()(key);
+            std::size_t i = find_free(hash);
+            if(_ctrl[i] == detail::ctrl_empty) {
+                // Tombstones are reused for free, empty slots count against the load factor
+                if(_growth_left == 0) {
+                    make_room();
+                    i = find_free(hash);
+                }
+                _growth_left--;
+            }
+            ::new(static_cast<void*>(_slots[i].storage))
+                value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+            _ctrl[i] = h2(hash);
+            _size++;
+            return {iterator(this, i), true};
+        }
+        std::pair<iterator, bool> insert(const value_type& value) {
+            return try_emplace(value.first, value.second);
+        }
+        V& operator[](key_type key) {
+            return try_emplace(key).first->second;
+        }
+
+        iterator find(key_type key) {
+            return iterator(this, find_index(key));
+        }
+        const_iterator find(key_type key) const {
+            return const_iterator(this, find_index(key));
+        }
+        bool contains(key_type key) const {
+            return find_index(key) != _capacity;
+        }
+        std::size_t count(key_type key) const {
+            return contains(key);
+        }
+
+        // Returns the iterator after pos
+        iterator erase(const_iterator pos) {
+            std::size_t i = pos._index;
+            _slots[i].get().~value_type();
+            _size--;
+            // A probe only passes a group that has no empty slot, so if this one has one no probe passes it and the
+            // slot can go back to empty rather than become a tombstone
+            if(group(&_ctrl[i / width * width]).match_empty()) {
+                _ctrl[i] = detail::ctrl_empty;
+                _growth_left++;
+            } else {
+                _ctrl[i] = detail::ctrl_deleted;
+            }
+            iterator next(this, i);
+            next.skip_free();
+            return next;
+        }
+        std::size_t erase(key_type key) {
+            std::size_t i = find_index(key);
+            if(i == _capacity) {
+                return 0;
+            }
+            erase(const_iterator(this, i));
+            return 1;
+        }
+        void clear() {
+            destroy();
+            if(_capacity) {
+                std::memset(_ctrl.get(), detail::ctrl_empty, _capacity);
+            }
+            _size = 0;
+            _growth_left = max_load(_capacity);
+        }
+        // Grows so that n elements fit without rehashing
+        void reserve(std::size_t n) {
+            std::size_t capacity = _capacity;
+            while(max_load(capacity) < n) {
+                capacity = capacity ? 2 * capacity : width;
+            }
+            if(capacity != _capacity) {
+                rehash(capacity);
+            }
+        }
+
+        iterator begin() {
+            iterator it(this, 0);
+            it.skip_free();
+            return it;
+        }
+        iterator end() {
+            return iterator(this, _capacity);
+        }
+        const_iterator begin() const {
+            const_iterator it(this, 0);
+            it.skip_free();
+            return it;
+        }
+        const_iterator end() const {
+            return const_iterator(this, _capacity);
+        }
+        std::size_t size() const {
+            return _size;
+        }
+        bool empty() const {
+            return _size == 0;
+        }
+        std::size_t capacity() const {
+            return _capacity;
+        }
+    };
+}
+
+#endif
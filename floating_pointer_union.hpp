@@ -0,0 +1,98 @@
+#ifndef FLOATING_POINTER_UNION_HPP
+#define FLOATING_POINTER_UNION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        template<typename T, typename... Ts> struct alternative_index;
+        template<typename T> struct alternative_index<T> {
+            static constexpr std::size_t value = 0;
+        };
+        template<typename T, typename... Ts> struct alternative_index<T, T, Ts...> {
+            static constexpr std::size_t value = 0;
+        };
+        template<typename T, typename U, typename... Ts> struct alternative_index<T, U, Ts...> {
+            static constexpr std::size_t value = 1 + alternative_index<T, Ts...>::value;
+        };
+    }
+
+    // A floating pointer to one of several types, remembering which. The address lives in bits 0-47 of a quiet NaN's
+    // payload and the alternative's index in bits 48-50, so the union is 8 bytes and up to eight types share it.
+    // visit() dispatches through a table of one function per alternative, which lets small polymorphic node types drop
+    // their vtable pointer. All null pointers compare equal regardless of alternative. Constructing one from an
+    // address wider than 48 bits throws out_of_range.
+    template<typename... Ts>
+    class floating_pointer_union {
+        static_assert(sizeof...(Ts) >= 1 && sizeof...(Ts) <= detail::boxed_max_tag + 1,
+                      "between one and eight alternatives");
+        double _value;
+        template<typename T>
+        using enable_alternative = typename std::enable_if<
+            detail::alternative_index<T, Ts...>::value < sizeof...(Ts)
+        >::type;
+    public:
+        static constexpr std::size_t alternatives = sizeof...(Ts);
+        template<typename T>
+        static constexpr std::size_t index_of = detail::alternative_index<T, Ts...>::value;
+
+        floating_pointer_union() : _value(NAN) {}
+        floating_pointer_union(std::nullptr_t) : floating_pointer_union() {}
+        template<typename T, typename = enable_alternative<T>>
+        floating_pointer_union(floating_pointer<T> ptr)
+            : _value(detail::box_tagged(std::uintptr_t(ptr), unsigned(index_of<T>))) {}
+        template<typename T, typename = enable_alternative<T>>
+        floating_pointer_union(T* ptr) : floating_pointer_union(floating_pointer<T>(ptr)) {}
+
+        std::size_t index() const {
+            return detail::unbox_tag(_value);
+        }
+        template<typename T, typename = enable_alternative<T>>
+        bool holds() const {
+            return index() == index_of<T>;
+        }
+        // Null when the union points to another alternative
+        template<typename T, typename = enable_alternative<T>>
+        floating_pointer<T> get_if() const {
+            return holds<T>() ? get<T>() : floating_pointer<T>(nullptr);
+        }
+        // Unchecked
+        template<typename T, typename = enable_alternative<T>>
+        floating_pointer<T> get() const {
+            return reinterpret_cast<T*>(detail::unbox_address(_value));
+        }
+        explicit operator bool() const {
+            return detail::unbox_address(_value) != 0;
+        }
+        friend bool operator==(floating_pointer_union a, floating_pointer_union b) {
+            return detail::unbox_nan(a._value) == detail::unbox_nan(b._value) || (!a && !b);
+        }
+        friend bool operator!=(floating_pointer_union a, floating_pointer_union b) {
+            return !(a == b);
+        }
+        // The union as the NaN it is, for storing alongside other doubles
+        explicit operator double() const {
+            return _value;
+        }
+
+        // Calls f(floating_pointer<T>) for the alternative T pointed to, also when the pointer is null
+        template<typename F>
+        decltype(auto) visit(F&& f) const {
+            using first = typename std::tuple_element<0, std::tuple<Ts...>>::type;
+            using result = decltype(f(std::declval<floating_pointer<first>>()));
+            using entry = result (*)(F&, const floating_pointer_union&);
+            static constexpr entry table[] = {
+                [](F& f, const floating_pointer_union& u) -> result { return f(u.template get<Ts>()); }...
+            };
+            return table[index()](f, *this);
+        }
+    };
+}
+
+#endif
@@ -4,24 +4,170 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
 
 namespace based {
     static_assert(std::numeric_limits<double>::is_iec559);
 
-    template<typename T>
+    namespace detail {
+        inline std::uint64_t to_bits(double value) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        inline double from_bits(std::uint64_t bits) {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        // A quiet NaN has an all-ones exponent and the top mantissa bit set, leaving 51 mantissa bits (and the sign)
+        // free. A payload of zero is the NaN behind nanptr.
+        constexpr std::uint64_t quiet_nan_bits = 0x7ff8000000000000;
+        constexpr int nan_payload_bits = 51;
+        constexpr std::uint64_t nan_payload_mask = (std::uint64_t(1) << nan_payload_bits) - 1;
+        inline double box_nan(std::uint64_t payload) {
+            return from_bits(quiet_nan_bits | (payload & nan_payload_mask));
+        }
+        inline std::uint64_t unbox_nan(double value) {
+            return to_bits(value) & nan_payload_mask;
+        }
+        // A tagged address in a NaN payload, the layout floating_value and floating_pointer_union share: the address
+        // in bits 0-47 and a tag of up to boxed_max_tag in bits 48-50. A wider address would come back as a different
+        // pointer, so boxing one throws out_of_range.
+        constexpr int boxed_tag_shift = 48;
+        constexpr std::uint64_t boxed_address_mask = (std::uint64_t(1) << boxed_tag_shift) - 1;
+        constexpr unsigned boxed_max_tag = 7;
+        inline double box_tagged(std::uintptr_t address, unsigned tag) {
+            if(address > boxed_address_mask) {
+                throw std::out_of_range("boxed addresses must fit in 48 bits");
+            }
+            return box_nan((std::uint64_t(tag) << boxed_tag_shift) | address);
+        }
+        inline unsigned unbox_tag(double value) {
+            return unsigned(unbox_nan(value) >> boxed_tag_shift);
+        }
+        inline std::uintptr_t unbox_address(double value) {
+            return std::uintptr_t(to_bits(value) & boxed_address_mask);
+        }
+
+        // Murmur3's 64 bit finalizer. Addresses differ in the middle bits of a double and never in its low ones, and
+        // here every output bit depends on every input bit, so a table can take its index and tag from either end.
+        inline std::uint64_t mix_bits(std::uint64_t x) {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccd;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53;
+            x ^= x >> 33;
+            return x;
+        }
+        // The bits std::hash<floating_pointer> mixes: -0.0 is folded into 0.0, as == equates them, and every NaN into
+        // the quiet NaN behind nanptr
+        inline std::uint64_t hash_bits(double value) {
+            if(value == 0) {
+                return 0;
+            }
+            if(value != value) {
+                return quiet_nan_bits;
+            }
+            return to_bits(value);
+        }
+
+        // What floating_pointer needs from its representation type
+        template<typename Repr> struct repr_traits {
+            static constexpr bool is_repr = std::is_floating_point<Repr>::value;
+            static constexpr int digits = std::numeric_limits<Repr>::digits;
+            static Repr abs(Repr x) {
+                return std::abs(x);
+            }
+            static Repr sqrt(Repr x) {
+                return std::sqrt(x);
+            }
+            static Repr fmod(Repr x, Repr y) {
+                return std::fmod(x, y);
+            }
+            static bool signbit(Repr x) {
+                return std::signbit(x);
+            }
+        };
+        #if defined(__SIZEOF_FLOAT128__) && defined(__GLIBC__)
+         #define FLOATING_POINTERS_HAS_FLOAT128 1
+        template<> struct repr_traits<__float128> {
+            static constexpr bool is_repr = true;
+            static constexpr int digits = __FLT128_MANT_DIG__;
+            static __float128 abs(__float128 x) {
+                return __builtin_fabsf128(x);
+            }
+            static __float128 sqrt(__float128 x) {
+                return __builtin_sqrtf128(x);
+            }
+            static __float128 fmod(__float128 x, __float128 y) {
+                return fmodf128(x, y);
+            }
+            static bool signbit(__float128 x) {
+                return __builtin_signbit(x);
+            }
+        };
+        #endif
+
+        [[noreturn]] inline void precision_trap() {
+            #if defined(__GNUC__)
+            __builtin_trap();
+            #else
+            std::abort();
+            #endif
+        }
+
+        // Defining FLOATING_POINTERS_CHECKED makes constructing a floating pointer from an address the representation
+        // cannot hold exactly trap instead of silently rounding. Without it the conversion is a single instruction.
+        template<typename Repr> constexpr Repr to_repr(std::uintptr_t address) {
+            #ifdef FLOATING_POINTERS_CHECKED
+            if(std::uintptr_t(Repr(address)) != address) {
+                precision_trap();
+            }
+            #endif
+            return Repr(address);
+        }
+    }
+
+    // Repr is the floating type holding the address: double (the default), float, long double or __float128. Addresses
+    // below 2^address_bits are held exactly, which for double covers 48 bit but not 57 bit (LA57) address spaces.
+    template<typename T, typename Repr = double>
     class floating_pointer {
-        double _ptr;
-        static constexpr std::size_t unit = sizeof(T);
-        explicit constexpr floating_pointer(double ptr) : _ptr(ptr) {}
+        static_assert(detail::repr_traits<Repr>::is_repr, "floating_pointer needs a floating point representation");
+        using math = detail::repr_traits<Repr>;
+        Repr _ptr;
+        static constexpr Repr unit = sizeof(T);
+        explicit constexpr floating_pointer(Repr ptr) : _ptr(ptr) {}
+        template<typename, typename> friend class floating_pointer;
+        friend struct std::hash<floating_pointer>;
     public:
+        using repr_type = Repr;
+        static constexpr int address_bits = detail::repr_traits<Repr>::digits;
+        // Iterator traits
+        using element_type = T;
+        using value_type = typename std::remove_cv<T>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::random_access_iterator_tag;
+        #ifdef __cpp_lib_ranges
+        using iterator_concept = std::contiguous_iterator_tag;
+        #endif
         constexpr floating_pointer() = default;
-        constexpr floating_pointer(T* ptr) : _ptr(uintptr_t(ptr)) {}
+        constexpr floating_pointer(T* ptr) : _ptr(detail::to_repr<Repr>(uintptr_t(ptr))) {}
         constexpr floating_pointer(std::nullptr_t) : _ptr(0) {}
+        // Qualification conversions (T* -> const T*) keep the underlying value, nan and infinity pointers included
+        template<typename U, typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value, int>::type = 0>
+        constexpr floating_pointer(floating_pointer<U, Repr> other) : _ptr(other._ptr) {}
         // Conversion
-        constexpr operator bool() const {
+        explicit constexpr operator bool() const {
             return _ptr;
         }
         constexpr operator T*() const {
@@ -40,7 +186,7 @@ namespace based {
         constexpr T* operator->() const {
             return (T*)uintptr_t(_ptr);
         }
-        constexpr T& operator[](std::size_t i) const {
+        constexpr T& operator[](std::ptrdiff_t i) const {
             return ((T*)uintptr_t(_ptr))[i];
         }
         // Comparison
@@ -50,6 +196,12 @@ namespace based {
         constexpr bool operator!=(floating_pointer other) const {
             return _ptr != other._ptr;
         }
+        constexpr bool operator==(std::nullptr_t) const {
+            return _ptr == 0;
+        }
+        constexpr bool operator!=(std::nullptr_t) const {
+            return _ptr != 0;
+        }
         constexpr bool operator<(floating_pointer other) const {
             return _ptr < other._ptr;
         }
@@ -62,6 +214,31 @@ namespace based {
         constexpr bool operator>=(floating_pointer other) const {
             return _ptr >= other._ptr;
         }
+        // Tags. The low log2(alignof(T)) bits of an aligned address are always zero and can hold a small tag, which
+        // travels with copies and takes part in the comparisons above. A tagged pointer must be untagged() before it is
+        // dereferenced. Tags are exact for addresses below 2^address_bits.
+        static constexpr std::uintptr_t max_tag() {
+            return alignof(T) - 1;
+        }
+        template<std::uintptr_t N>
+        constexpr floating_pointer with_tag() const {
+            static_assert(N <= alignof(T) - 1, "alignof(T) leaves too few low bits for this tag");
+            return with_tag(N);
+        }
+        // tag must not exceed max_tag()
+        constexpr floating_pointer with_tag(std::uintptr_t tag) const {
+            return floating_pointer(untagged()._ptr + Repr(tag));
+        }
+        constexpr std::uintptr_t tag() const {
+            return uintptr_t(_ptr) & max_tag();
+        }
+        constexpr floating_pointer untagged() const {
+            return floating_pointer(_ptr - Repr(tag()));
+        }
+        // Compares addresses, ignoring tags
+        constexpr bool same_address(floating_pointer other) const {
+            return untagged() == other.untagged();
+        }
         // Arithmetic
         constexpr floating_pointer& operator++() {
             _ptr += unit;
@@ -103,60 +280,75 @@ namespace based {
         }
         template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
         constexpr floating_pointer& operator%=(V v) {
-            _ptr = std::fmod(ptr, v);
+            _ptr = math::fmod(_ptr, Repr(v));
             return *this;
         }
+        // Flips the sign bit, which no real address uses
+        constexpr floating_pointer operator-() const {
+            return floating_pointer(-_ptr);
+        }
         template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
         constexpr floating_pointer operator+(V v) const {
-            return _ptr + v * unit;
+            return floating_pointer(_ptr + v * unit);
         }
         template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
         constexpr floating_pointer operator-(V v) const {
-            return _ptr - v * unit;
+            return floating_pointer(_ptr - v * unit);
+        }
+        template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
+        friend constexpr floating_pointer operator+(V v, floating_pointer ptr) {
+            return ptr + v;
+        }
+        constexpr difference_type operator-(floating_pointer other) const {
+            return difference_type((_ptr - other._ptr) / unit);
         }
         template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
         constexpr floating_pointer operator*(V v) const {
-            return _ptr * v;
+            return floating_pointer(_ptr * v);
         }
         template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
         constexpr floating_pointer operator/(V v) const {
-            return _ptr / unit;
+            return floating_pointer(_ptr / v);
         }
         template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
         constexpr floating_pointer operator%(V v) const {
-            return std::fmod(ptr, v);
+            return floating_pointer(math::fmod(_ptr, Repr(v)));
         }
         // Math
-        friend constexpr floating_pointer<T> abs(floating_pointer<T> ptr) {
-            return {std::abs(ptr._ptr)};
+        friend constexpr floating_pointer abs(floating_pointer ptr) {
+            return floating_pointer(math::abs(ptr._ptr));
+        }
+        friend constexpr floating_pointer sqrt(floating_pointer ptr) {
+            return floating_pointer(math::sqrt(ptr._ptr));
         }
-        friend constexpr floating_pointer<T> sqrt(floating_pointer<T> ptr) {
-            return {std::sqrt(ptr._ptr)};
+        // True for negative pointers, negativenullptr and negativeinfinityptr included
+        friend constexpr bool signbit(floating_pointer ptr) {
+            return math::signbit(ptr._ptr);
         }
         template<typename V, typename std::enable_if<std::is_arithmetic<V>::value, int>::type = 0>
-        friend constexpr floating_pointer<T> fmod(floating_pointer<T> x, V v) {
-            return {x % v};
+        friend constexpr floating_pointer fmod(floating_pointer x, V v) {
+            return x % v;
         }
         template<typename U, typename V, typename std::enable_if<
                                                       std::is_arithmetic<U>::value && std::is_arithmetic<V>::value,
                                                       int
                                                   >::type = 0>
-        friend constexpr floating_pointer<T> fma(floating_pointer<T> x, U y, V z) {
-            return {x * y + z};
+        friend constexpr floating_pointer fma(floating_pointer x, U y, V z) {
+            return x * y + z;
         }
         template<typename U, typename V, typename std::enable_if<
                                                       std::is_arithmetic<U>::value && std::is_arithmetic<V>::value,
                                                       int
                                                   >::type = 0>
-        friend constexpr floating_pointer<T> fma(U x, floating_pointer<T> y, V z) {
-            return {x * y + z};
+        friend constexpr floating_pointer fma(U x, floating_pointer y, V z) {
+            return y * x + z;
         }
         template<typename U, typename V, typename std::enable_if<
                                                       std::is_arithmetic<U>::value && std::is_arithmetic<V>::value,
                                                       int
                                                   >::type = 0>
-        friend constexpr floating_pointer<T> fma(U x, V y, floating_pointer<T> z) {
-            return {x * y + z};
+        friend constexpr floating_pointer fma(U x, V y, floating_pointer z) {
+            return z + x * y;
         }
         // Constants
         friend struct infinityptr_t;
@@ -166,23 +358,23 @@ namespace based {
     };
 
     struct infinityptr_t {
-        template<typename T> operator floating_pointer<T>() const {
-            return floating_pointer<T>(INFINITY);
+        template<typename T, typename Repr> operator floating_pointer<T, Repr>() const {
+            return floating_pointer<T, Repr>(Repr(INFINITY));
         }
     };
     struct nanptr_t {
-        template<typename T> operator floating_pointer<T>() const {
-            return floating_pointer<T>(NAN);
+        template<typename T, typename Repr> operator floating_pointer<T, Repr>() const {
+            return floating_pointer<T, Repr>(Repr(NAN));
         }
     };
     struct negativenullptr_t {
-        template<typename T> operator floating_pointer<T>() const {
-            return floating_pointer<T>(-0.0);
+        template<typename T, typename Repr> operator floating_pointer<T, Repr>() const {
+            return floating_pointer<T, Repr>(Repr(-0.0));
         }
     };
     struct negativeinfinityptr_t {
-        template<typename T> operator floating_pointer<T>() const {
-            return floating_pointer<T>(-INFINITY);
+        template<typename T, typename Repr> operator floating_pointer<T, Repr>() const {
+            return floating_pointer<T, Repr>(Repr(-INFINITY));
         }
     };
 
@@ -194,8 +386,40 @@ namespace based {
     namespace detail {
         template<typename T> constexpr T& id(T& t) { return t; };
         template<typename T> void id(T&&) = delete;
+
+        // The raw bits of a double floating pointer, for atomics that compare and swap bit patterns
+        template<typename T> std::uint64_t pointer_bits(floating_pointer<T> ptr) {
+            std::uint64_t bits;
+            std::memcpy(&bits, static_cast<const void*>(&ptr), sizeof(bits));
+            return bits;
+        }
+        template<typename T> floating_pointer<T> pointer_from_bits(std::uint64_t bits) {
+            floating_pointer<T> ptr;
+            std::memcpy(static_cast<void*>(&ptr), &bits, sizeof(bits));
+            return ptr;
+        }
+
+        // Maps double bits to unsigned keys ordered like IEEE 754 totalOrder: positive values get the sign bit set,
+        // negative ones are inverted so larger magnitudes come first
+        inline std::uint64_t total_order_key(std::uint64_t bits) {
+            return bits ^ (std::uint64_t(std::int64_t(bits) >> 63) | 0x8000000000000000);
+        }
+        inline std::uint64_t total_order_bits(std::uint64_t key) {
+            return key ^ (key >> 63 ? 0x8000000000000000 : ~std::uint64_t(0));
+        }
     }
 
+    // IEEE 754 totalOrder on floating pointers: -nan < negativeinfinityptr < ... < negativenullptr < nullptr < ... <
+    // infinityptr < nanptr, NaNs further ordered by payload. Unlike operator<, which is IEEE comparison where NaNs are
+    // unordered, this is a strict weak (indeed total) order over every floating pointer, as std::sort and std::map
+    // require. Addresses compare as with operator<.
+    struct total_order_less {
+        template<typename T>
+        bool operator()(floating_pointer<T> a, floating_pointer<T> b) const {
+            return detail::total_order_key(detail::pointer_bits(a)) < detail::total_order_key(detail::pointer_bits(b));
+        }
+    };
+
     template<typename T>
     class floating_reference_wrapper {
         floating_pointer<T> ptr;
@@ -221,4 +445,28 @@ namespace based {
     template<typename T> floating_reference_wrapper(T&) -> floating_reference_wrapper<T>;
 }
 
+// Lets std::to_address, and through it the contiguous iterator machinery, see through floating pointers
+template<typename T, typename Repr>
+struct std::pointer_traits<based::floating_pointer<T, Repr>> {
+    using pointer = based::floating_pointer<T, Repr>;
+    using element_type = T;
+    using difference_type = std::ptrdiff_t;
+    template<typename U> using rebind = based::floating_pointer<U, Repr>;
+    static constexpr pointer pointer_to(T& r) noexcept {
+        return pointer(std::addressof(r));
+    }
+    static constexpr T* to_address(pointer p) noexcept {
+        return p;
+    }
+};
+
+// Hashes agree with ==, so negativenullptr hashes like nullptr. Every NaN pointer hashes like nanptr, though as NaNs
+// never compare equal a NaN key put in a std::unordered_map is never found again; floating_pointer_map finds them.
+template<typename T, typename Repr>
+struct std::hash<based::floating_pointer<T, Repr>> {
+    std::size_t operator()(based::floating_pointer<T, Repr> ptr) const noexcept {
+        return std::size_t(based::detail::mix_bits(based::detail::hash_bits(double(ptr._ptr))));
+    }
+};
+
 #endif
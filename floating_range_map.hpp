@@ -0,0 +1,234 @@
+#ifndef FLOATING_RANGE_MAP_HPP
+#define FLOATING_RANGE_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    // Maps non-overlapping address ranges to values and answers which range holds a pointer into its interior, as a
+    // debug allocator or a profiler needs to for every sampled address. Lookups go through a radix page table over
+    // the 48 bit address space rather than a search tree: three levels of 4096 entries index the 4 KiB pages, and
+    // each page lists the ranges starting in it, sorted, and the range covering its first byte if one started
+    // earlier. A lookup is three table loads, a search among the ranges starting in one page, and a bounds check,
+    // however many ranges there are. Tables are allocated as ranges reach their part of the address space; inserting
+    // or erasing a range costs a store per page it spans.
+    //
+    // Pointers that are not ordinary addresses below 2^48 (negative, infinite, NaN) are never found and cannot start
+    // a range. Not copyable.
+    template<typename V>
+    class floating_range_map {
+    public:
+        struct range {
+            const floating_pointer<std::byte> first;
+            const std::size_t bytes;
+            V value;
+        };
+    private:
+        static constexpr unsigned address_bits = 48;
+        static constexpr unsigned page_bits = 12;
+        static constexpr unsigned level_bits = 12; // three levels cover the 36 bit page numbers
+        static constexpr std::size_t fanout = std::size_t(1) << level_bits;
+        static constexpr std::uintptr_t address_limit = std::uintptr_t(1) << address_bits;
+        static constexpr std::uint32_t none = 0xffffffff;
+
+        struct page {
+            // Ranges starting in the page as offset << 32 | id, sorted by offset
+            std::vector<std::uint64_t> starts;
+            // The range holding the page's first byte, when it started on an earlier page
+            std::uint32_t covering = none;
+        };
+        struct leaf_table {
+            page pages[fanout];
+        };
+        struct mid_table {
+            std::unique_ptr<leaf_table> leaves[fanout];
+        };
+
+        std::unique_ptr<std::unique_ptr<mid_table>[]> _root;
+        std::vector<std::optional<range>> _ranges; // indexed by id
+        std::vector<std::uint32_t> _free_ids;
+        std::size_t _size = 0;
+
+        // The address p holds, if it is an ordinary pointer below address_limit
+        template<typename T>
+        static bool address_of(floating_pointer<T> p, std::uintptr_t& address) {
+            double value = detail::from_bits(detail::pointer_bits(p));
+            if(!(value >= 0 && value < double(address_limit))) {
+                return false;
+            }
+            address = std::uintptr_t(value);
+            return true;
+        }
+        const page* find_page(std::uintptr_t page_number) const {
+            if(!_root) {
+                return nullptr;
+            }
+            const mid_table* mid = _root[page_number >> (2 * level_bits)].get();
+            if(!mid) {
+                return nullptr;
+            }
+            const leaf_table* leaf = mid->leaves[(page_number >> level_bits) & (fanout - 1)].get();
+            if(!leaf) {
+                return nullptr;
+            }
+            return &leaf->pages[page_number & (fanout - 1)];
+        }
+        page& make_page(std::uintptr_t page_number) {
+            if(!_root) {
+                _root.reset(new std::unique_ptr<mid_table>[fanout]);
+            }
+            auto& mid = _root[page_number >> (2 * level_bits)];
+            if(!mid) {
+                mid.reset(new mid_table);
+            }
+            auto& leaf = mid->leaves[(page_number >> level_bits) & (fanout - 1)];
+            if(!leaf) {
+                leaf.reset(new leaf_table);
+            }
+            return leaf->pages[page_number & (fanout - 1)];
+        }
+
+        // The id of the range holding address, or none
+        std::uint32_t find_id(std::uintptr_t address) const {
+            const page* p = find_page(address >> page_bits);
+            if(!p) {
+                return none;
+            }
+            // The last range starting in the page at or before address, else the one covering the page start
+            std::uint64_t offset = address & ((std::uintptr_t(1) << page_bits) - 1);
+            auto after = std::upper_bound(p->starts.begin(), p->starts.end(), offset << 32 | none);
+            std::uint32_t id = after == p->starts.begin() ? p->covering : std::uint32_t(*(after - 1));
+            if(id == none) {
+                return none;
+            }
+            const range& r = *_ranges[id];
+            return address - std::uintptr_t(r.first) < r.bytes ? id : none;
+        }
+        // Whether [begin, end) intersects a range: one holds begin or one starts inside
+        bool overlaps(std::uintptr_t begin, std::uintptr_t end) const {
+            if(find_id(begin) != none) {
+                return true;
+            }
+            for(std::uintptr_t n = begin >> page_bits; n <= (end - 1) >> page_bits; n++) {
+                const page* p = find_page(n);
+                if(!p) {
+                    continue;
+                }
+                for(std::uint64_t s : p->starts) {
+                    std::uintptr_t start = (n << page_bits) + std::uintptr_t(s >> 32);
+                    if(start > begin && start < end) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+    public:
+        floating_range_map() = default;
+        floating_range_map(floating_range_map&&) noexcept = default;
+        floating_range_map& operator=(floating_range_map&&) noexcept = default;
+
+        // Maps [first, first + count) to value. Fails, leaving the map unchanged, if the range is empty, reaches past
+        // 2^48 or overlaps one already present.
+        template<typename T>
+        bool insert(floating_pointer<T> first, std::size_t count, V value) {
+            std::uintptr_t begin;
+            if(!address_of(first, begin) || count == 0 || count > (address_limit - begin) / sizeof(T)) {
+                return false;
+            }
+            std::uintptr_t end = begin + count * sizeof(T);
+            if(overlaps(begin, end)) {
+                return false;
+            }
+            std::uint32_t id;
+            if(_free_ids.empty()) {
+                id = std::uint32_t(_ranges.size());
+                _ranges.emplace_back();
+            } else {
+                id = _free_ids.back();
+                _free_ids.pop_back();
+            }
+            _ranges[id].emplace(range{reinterpret_cast<std::byte*>(begin), end - begin, std::move(value)});
+            std::vector<std::uint64_t>& starts = make_page(begin >> page_bits).starts;
+            std::uint64_t start = std::uint64_t(begin & ((std::uintptr_t(1) << page_bits) - 1)) << 32 | id;
+            starts.insert(std::upper_bound(starts.begin(), starts.end(), start), start);
+            for(std::uintptr_t n = (begin >> page_bits) + 1; n <= (end - 1) >> page_bits; n++) {
+                make_page(n).covering = id;
+            }
+            _size++;
+            return true;
+        }
+        // Removes the range starting exactly at first
+        template<typename T>
+        std::size_t erase(floating_pointer<T> first) {
+            std::uintptr_t begin;
+            if(!address_of(first, begin)) {
+                return 0;
+            }
+            std::uint32_t id = find_id(begin);
+            if(id == none || std::uintptr_t(_ranges[id]->first) != begin) {
+                return 0;
+            }
+            std::uintptr_t end = begin + _ranges[id]->bytes;
+            std::vector<std::uint64_t>& starts = make_page(begin >> page_bits).starts;
+            std::uint64_t start = std::uint64_t(begin & ((std::uintptr_t(1) << page_bits) - 1)) << 32 | id;
+            starts.erase(std::lower_bound(starts.begin(), starts.end(), start));
+            for(std::uintptr_t n = (begin >> page_bits) + 1; n <= (end - 1) >> page_bits; n++) {
+                make_page(n).covering = none;
+            }
+            _ranges[id].reset();
+            _free_ids.push_back(id);
+            _size--;
+            return 1;
+        }
+        void clear() {
+            _root.reset();
+            _ranges.clear();
+            _free_ids.clear();
+            _size = 0;
+        }
+
+        // The range holding p, which may point anywhere inside it, or null
+        template<typename T>
+        const range* find(floating_pointer<T> p) const {
+            std::uintptr_t address;
+            if(!address_of(p, address)) {
+                return nullptr;
+            }
+            std::uint32_t id = find_id(address);
+            return id == none ? nullptr : &*_ranges[id];
+        }
+        template<typename T>
+        range* find(floating_pointer<T> p) {
+            return const_cast<range*>(static_cast<const floating_range_map*>(this)->find(p));
+        }
+        template<typename T>
+        bool contains(floating_pointer<T> p) const {
+            return find(p) != nullptr;
+        }
+        // Calls f(const range&) on every range, in no particular order
+        template<typename F>
+        void for_each(F f) const {
+            for(const auto& r : _ranges) {
+                if(r) {
+                    f(*r);
+                }
+            }
+        }
+        std::size_t size() const {
+            return _size;
+        }
+        bool empty() const {
+            return _size == 0;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,462 @@
+#ifndef FLOATING_RB_TREE_HPP
+#define FLOATING_RB_TREE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    // An ordered map implemented as a red-black tree over floating pointers. A node's color lives in the sign bit of
+    // its parent pointer (negative means red), which no address uses, so nodes carry three links and the element and no
+    // color field. Links are stored non-negative everywhere else; the sign is stripped with abs() before following a
+    // parent pointer.
+    //
+    // Iterators are forward iterators in key order and stay valid until their element is erased.
+    template<typename K, typename V, typename Compare = std::less<K>>
+    class floating_rb_tree {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<const K, V>;
+        using key_compare = Compare;
+        using size_type = std::size_t;
+    private:
+        struct node {
+            floating_pointer<node> left;
+            floating_pointer<node> right;
+            floating_pointer<node> parent_and_color;
+            value_type value;
+        };
+        using link = floating_pointer<node>;
+
+        link _root = nullptr;
+        std::size_t _size = 0;
+        Compare _compare;
+
+        static link parent(link n) {
+            return abs(n->parent_and_color);
+        }
+        // Null links are black
+        static bool is_red(link n) {
+            return n && signbit(n->parent_and_color);
+        }
+        static void set_parent(link n, link p) {
+            n->parent_and_color = is_red(n) ? -p : p;
+        }
+        static void set_red(link n, bool red) {
+            n->parent_and_color = red ? -parent(n) : parent(n);
+        }
+        static link minimum(link n) {
+            while(n->left) {
+                n = n->left;
+            }
+            return n;
+        }
+        static link successor(link n) {
+            if(n->right) {
+                return minimum(n->right);
+            }
+            link p = parent(n);
+            while(p && n == p->right) {
+                n = p;
+                p = parent(p);
+            }
+            return p;
+        }
+
+        void replace_child(link p, link old, link replacement) {
+            if(!p) {
+                _root = replacement;
+            } else if(p->left == old) {
+                p->left = replacement;
+            } else {
+                p->right = replacement;
+            }
+        }
+        void rotate_left(link x) {
+            link y = x->right;
+            x->right = y->left;
+            if(y->left) {
+                set_parent(y->left, x);
+            }
+            set_parent(y, parent(x));
+            replace_child(parent(x), x, y);
+            y->left = x;
+            set_parent(x, y);
+        }
+        void rotate_right(link x) {
+            link y = x->left;
+            x->left = y->right;
+            if(y->right) {
+                set_parent(y->right, x);
+            }
+            set_parent(y, parent(x));
+            replace_child(parent(x), x, y);
+            y->right = x;
+            set_parent(x, y);
+        }
+
+        void insert_fixup(link n) {
+            while(is_red(parent(n))) {
+                link p = parent(n);
+                link g = parent(p);
+                if(p == g->left) {
+                    link u = g->right;
+                    if(is_red(u)) {
+                        set_red(p, false);
+                        set_red(u, false);
+                        set_red(g, true);
+                        n = g;
+                        continue;
+                    }
+                    if(n == p->right) {
+                        n = p;
+                        rotate_left(n);
+                        p = parent(n);
+                    }
+                    set_red(p, false);
+                    set_red(g, true);
+                    rotate_right(g);
+                } else {
+                    link u = g->left;
+                    if(is_red(u)) {
+                        set_red(p, false);
+                        set_red(u, false);
+                        set_red(g, true);
+                        n = g;
+                        continue;
+                    }
+                    if(n == p->left) {
+                        n = p;
+                        rotate_right(n);
+                        p = parent(n);
+                    }
+                    set_red(p, false);
+                    set_red(g, true);
+                    rotate_left(g);
+                }
+            }
+            set_red(_root, false);
+        }
+
+        // x replaced a removed black node and may be null, hence x_parent
+        void erase_fixup(link x, link x_parent) {
+            while(x != _root && !is_red(x)) {
+                if(x == x_parent->left) {
+                    link w = x_parent->right;
+                    if(is_red(w)) {
+                        set_red(w, false);
+                        set_red(x_parent, true);
+                        rotate_left(x_parent);
+                        w = x_parent->right;
+                    }
+                    if(!is_red(w->left) && !is_red(w->right)) {
+                        set_red(w, true);
+                        x = x_parent;
+                        x_parent = parent(x);
+                        continue;
+                    }
+                    if(!is_red(w->right)) {
+                        set_red(w->left, false);
+                        set_red(w, true);
+                        rotate_right(w);
+                        w = x_parent->right;
+                    }
+                    set_red(w, is_red(x_parent));
+                    set_red(x_parent, false);
+                    set_red(w->right, false);
+                    rotate_left(x_parent);
+                } else {
+                    link w = x_parent->left;
+                    if(is_red(w)) {
+                        set_red(w, false);
+                        set_red(x_parent, true);
+                        rotate_right(x_parent);
+                        w = x_parent->left;
+                    }
+                    if(!is_red(w->left) && !is_red(w->right)) {
+                        set_red(w, true);
+                        x = x_parent;
+                        x_parent = parent(x);
+                        continue;
+                    }
+                    if(!is_red(w->left)) {
+                        set_red(w->right, false);
+                        set_red(w, true);
+                        rotate_left(w);
+                        w = x_parent->left;
+                    }
+                    set_red(w, is_red(x_parent));
+                    set_red(x_parent, false);
+                    set_red(w->left, false);
+                    rotate_right(x_parent);
+                }
+                x = _root;
+            }
+            if(x) {
+                set_red(x, false);
+            }
+        }
+
+        void erase_node(link z) {
+            link x;
+            link x_parent;
+            bool removed_red;
+            if(!z->left || !z->right) {
+                x = z->left ? z->left : z->right;
+                x_parent = parent(z);
+                removed_red = is_red(z);
+                if(x) {
+                    set_parent(x, x_parent);
+                }
+                replace_child(x_parent, z, x);
+            } else {
+                // Splice out z's successor y and put it in z's place with z's color
+                link y = minimum(z->right);
+                removed_red = is_red(y);
+                x = y->right;
+                if(parent(y) == z) {
+                    x_parent = y;
+                } else {
+                    x_parent = parent(y);
+                    if(x) {
+                        set_parent(x, x_parent);
+                    }
+                    x_parent->left = x;
+                    y->right = z->right;
+                    set_parent(y->right, y);
+                }
+                y->left = z->left;
+                set_parent(y->left, y);
+                set_parent(y, parent(z));
+                replace_child(parent(z), z, y);
+                set_red(y, is_red(z));
+            }
+            delete static_cast<node*>(z);
+            _size--;
+            if(!removed_red) {
+                erase_fixup(x, x_parent);
+            }
+        }
+
+        link find_node(const K& key) const {
+            link n = _root;
+            while(n) {
+                if(_compare(key, n->value.first)) {
+                    n = n->left;
+                } else if(_compare(n->value.first, key)) {
+                    n = n->right;
+                } else {
+                    return n;
+                }
+            }
+            return nullptr;
+        }
+
+        static link clone(link n, link p) {
+            if(!n) {
+                return nullptr;
+            }
+            link copy = new node{nullptr, nullptr, is_red(n) ? -p : p, n->value};
+            copy->left = clone(n->left, copy);
+            copy->right = clone(n->right, copy);
+            return copy;
+        }
+        static void destroy(link n) {
+            while(n) {
+                destroy(n->right);
+                link left = n->left;
+                delete static_cast<node*>(n);
+                n = left;
+            }
+        }
+
+        // The black height of n's subtree, or -1 if it breaks an invariant below n: parent links, key order within
+        // (low, high), no red node with a red child, or equal black heights on both sides
+        int black_height(link n, link p, const K* low, const K* high) const {
+            if(!n) {
+                return 0;
+            }
+            if(parent(n) != p || (low && !_compare(*low, n->value.first))
+               || (high && !_compare(n->value.first, *high))
+               || (is_red(n) && (is_red(n->left) || is_red(n->right)))
+               || signbit(n->left) || signbit(n->right)) {
+                return -1;
+            }
+            int left = black_height(n->left, n, low, &n->value.first);
+            int right = black_height(n->right, n, &n->value.first, high);
+            if(left < 0 || left != right) {
+                return -1;
+            }
+            return left + !is_red(n);
+        }
+        std::size_t count(link n) const {
+            return n ? 1 + count(n->left) + count(n->right) : 0;
+        }
+
+        template<typename Value>
+        class basic_iterator {
+            link _node = nullptr;
+            friend class floating_rb_tree;
+            template<typename> friend class basic_iterator;
+            explicit basic_iterator(link n) : _node(n) {}
+        public:
+            using value_type = floating_rb_tree::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Value*;
+            using reference = Value&;
+            using iterator_category = std::forward_iterator_tag;
+            basic_iterator() = default;
+            // iterator -> const_iterator
+            template<typename U, typename std::enable_if<std::is_convertible<U*, Value*>::value, int>::type = 0>
+            basic_iterator(basic_iterator<U> other) : _node(other._node) {}
+            reference operator*() const {
+                return _node->value;
+            }
+            pointer operator->() const {
+                return &_node->value;
+            }
+            basic_iterator& operator++() {
+                _node = successor(_node);
+                return *this;
+            }
+            basic_iterator operator++(int) {
+                basic_iterator copy = *this;
+                ++*this;
+                return copy;
+            }
+            friend bool operator==(basic_iterator a, basic_iterator b) {
+                return a._node == b._node;
+            }
+            friend bool operator!=(basic_iterator a, basic_iterator b) {
+                return a._node != b._node;
+            }
+        };
+    public:
+        using iterator = basic_iterator<value_type>;
+        using const_iterator = basic_iterator<const value_type>;
+        // The per-element footprint: three floating pointers and the element
+        static constexpr std::size_t node_size = sizeof(node);
+
+        floating_rb_tree() = default;
+        explicit floating_rb_tree(const Compare& compare) : _compare(compare) {}
+        floating_rb_tree(const floating_rb_tree& other)
+            : _root(clone(other._root, nullptr)), _size(other._size), _compare(other._compare) {}
+        floating_rb_tree(floating_rb_tree&& other) noexcept
+            : _root(other._root), _size(other._size), _compare(std::move(other._compare)) {
+            other._root = nullptr;
+            other._size = 0;
+        }
+        floating_rb_tree& operator=(floating_rb_tree other) noexcept {
+            std::swap(_root, other._root);
+            std::swap(_size, other._size);
+            std::swap(_compare, other._compare);
+            return *this;
+        }
+        ~floating_rb_tree() {
+            destroy(_root);
+        }
+
+        // Constructs V from args unless key is already present, like std::map::try_emplace
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+            link p = nullptr;
+            link n = _root;
+            bool left = false;
+            while(n) {
+                p = n;
+                if(_compare(key, n->value.first)) {
+                    n = n->left;
+                    left = true;
+                } else if(_compare(n->value.first, key)) {
+                    n = n->right;
+                    left = false;
+                } else {
+                    return {iterator(n), false};
+                }
+            }
+            // New nodes are red
+            n = new node{
+                nullptr, nullptr, -p,
+                value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                           std::forward_as_tuple(std::forward<Args>(args)...))
+            };
+            if(!p) {
+                _root = n;
+            } else if(left) {
+                p->left = n;
+            } else {
+                p->right = n;
+            }
+            _size++;
+            insert_fixup(n);
+            return {iterator(n), true};
+        }
+        std::pair<iterator, bool> insert(const value_type& value) {
+            return try_emplace(value.first, value.second);
+        }
+        V& operator[](const K& key) {
+            return try_emplace(key).first->second;
+        }
+
+        iterator find(const K& key) {
+            return iterator(find_node(key));
+        }
+        const_iterator find(const K& key) const {
+            return const_iterator(find_node(key));
+        }
+        bool contains(const K& key) const {
+            return bool(find_node(key));
+        }
+
+        std::size_t erase(const K& key) {
+            link n = find_node(key);
+            if(!n) {
+                return 0;
+            }
+            erase_node(n);
+            return 1;
+        }
+        // Returns the iterator following pos
+        iterator erase(const_iterator pos) {
+            link next = successor(pos._node);
+            erase_node(pos._node);
+            return iterator(next);
+        }
+        void clear() {
+            destroy(_root);
+            _root = nullptr;
+            _size = 0;
+        }
+
+        iterator begin() {
+            return iterator(_root ? minimum(_root) : _root);
+        }
+        iterator end() {
+            return iterator();
+        }
+        const_iterator begin() const {
+            return const_iterator(_root ? minimum(_root) : _root);
+        }
+        const_iterator end() const {
+            return const_iterator();
+        }
+        std::size_t size() const {
+            return _size;
+        }
+        bool empty() const {
+            return _size == 0;
+        }
+        // Checks the red-black invariants, key order, parent links and size. Linear time, for tests and debugging.
+        bool valid() const {
+            return !is_red(_root) && black_height(_root, nullptr, nullptr, nullptr) >= 0 && count(_root) == _size;
+        }
+    };
+}
+
+#endif
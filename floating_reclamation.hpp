@@ -0,0 +1,350 @@
+#ifndef FLOATING_RECLAMATION_HPP
+#define FLOATING_RECLAMATION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "floating_atomic.hpp"
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        struct retired_object {
+            void* ptr;
+            void (*deleter)(void*);
+            std::uint64_t epoch;
+        };
+        template<typename T> void delete_object(void* ptr) {
+            delete static_cast<T*>(ptr);
+        }
+
+        // Per-thread records of a reclamation domain. Records are never freed: a thread takes a released record or
+        // pushes a new one, and releases it when it exits, so scans can walk the list without synchronizing with
+        // thread exit.
+        template<typename Record>
+        class record_registry {
+            std::atomic<Record*> _head{nullptr};
+            std::atomic<std::size_t> _count{0};
+        public:
+            Record* acquire() {
+                for(Record* r = _head.load(std::memory_order_acquire); r; r = r->next) {
+                    bool expected = false;
+                    if(!r->in_use.load(std::memory_order_relaxed)
+                       && r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                        return r;
+                    }
+                }
+                Record* r = new Record();
+                r->in_use.store(true, std::memory_order_relaxed);
+                r->next = _head.load(std::memory_order_relaxed);
+                while(!_head.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+                _count.fetch_add(1, std::memory_order_relaxed);
+                return r;
+            }
+            void release(Record* r) {
+                r->in_use.store(false, std::memory_order_release);
+            }
+            std::size_t size() const {
+                return _count.load(std::memory_order_relaxed);
+            }
+            template<typename F>
+            void for_each(F&& f) const {
+                for(Record* r = _head.load(std::memory_order_acquire); r; r = r->next) {
+                    f(*r);
+                }
+            }
+        };
+
+        // Retired objects left behind by exited threads, adopted by the next thread to collect
+        class orphanage {
+            std::mutex _lock;
+            std::vector<retired_object> _orphans;
+            std::atomic<bool> _any{false};
+        public:
+            void leave(std::vector<retired_object>& retired) {
+                if(retired.empty()) {
+                    return;
+                }
+                std::lock_guard<std::mutex> guard(_lock);
+                _orphans.insert(_orphans.end(), retired.begin(), retired.end());
+                _any.store(true, std::memory_order_release);
+                retired.clear();
+            }
+            void adopt(std::vector<retired_object>& retired) {
+                if(!_any.load(std::memory_order_acquire)) {
+                    return;
+                }
+                std::lock_guard<std::mutex> guard(_lock);
+                retired.insert(retired.end(), _orphans.begin(), _orphans.end());
+                _orphans.clear();
+                _any.store(false, std::memory_order_relaxed);
+            }
+        };
+    }
+
+    // Epoch-based reclamation for nodes reached through floating pointers. A thread pins the domain for the duration
+    // of an operation; nodes unlinked meanwhile are retired instead of deleted, onto a per-thread list stamped with the
+    // global epoch. Every batch_size retirements the thread tries to advance the epoch, which succeeds once every
+    // pinned thread has observed the current one, and frees its nodes retired two or more epochs ago in one go.
+    //
+    // Pins nest and protect every node reachable during them, so traversals need no per-node work: protect() is a
+    // plain acquire load. A thread that stays pinned stalls reclamation for everyone. There is one process-wide
+    // domain, floating_epoch_domain::instance(), never destroyed.
+    class floating_epoch_domain {
+    public:
+        static constexpr std::size_t batch_size = 64;
+        static constexpr bool protects_traversal = true;
+    private:
+        struct alignas(64) record {
+            record* next = nullptr;
+            std::atomic<bool> in_use{false};
+            std::atomic<std::uint64_t> epoch{0}; // 0 while not pinned
+            unsigned nesting = 0;
+            std::vector<detail::retired_object> retired;
+        };
+        std::atomic<std::uint64_t> _epoch{1};
+        detail::record_registry<record> _records;
+        detail::orphanage _orphans;
+
+        struct thread_handle {
+            floating_epoch_domain* domain;
+            record* r;
+            explicit thread_handle(floating_epoch_domain* domain) : domain(domain), r(domain->_records.acquire()) {}
+            thread_handle(const thread_handle&) = delete;
+            thread_handle& operator=(const thread_handle&) = delete;
+            ~thread_handle() {
+                domain->collect(*r);
+                domain->_orphans.leave(r->retired);
+                domain->_records.release(r);
+            }
+        };
+        record& local() {
+            static thread_local thread_handle handle(this);
+            return *handle.r;
+        }
+
+        void enter(record& r) {
+            if(r.nesting++ == 0) {
+                r.epoch.store(_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                // Publish the pin before reading any shared pointer
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+        void leave(record& r) {
+            if(--r.nesting == 0) {
+                r.epoch.store(0, std::memory_order_release);
+            }
+        }
+        void try_advance() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::uint64_t current = _epoch.load(std::memory_order_seq_cst);
+            bool behind = false;
+            _records.for_each([&](record& r) {
+                std::uint64_t e = r.epoch.load(std::memory_order_seq_cst);
+                behind |= e != 0 && e != current;
+            });
+            if(!behind) {
+                _epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+            }
+        }
+        void collect(record& r) {
+            _orphans.adopt(r.retired);
+            try_advance();
+            std::uint64_t current = _epoch.load(std::memory_order_seq_cst);
+            auto kept = std::partition(r.retired.begin(), r.retired.end(), [&](const detail::retired_object& o) {
+                return o.epoch + 2 > current;
+            });
+            for(auto it = kept; it != r.retired.end(); ++it) {
+                it->deleter(it->ptr);
+            }
+            r.retired.erase(kept, r.retired.end());
+        }
+
+        floating_epoch_domain() = default;
+    public:
+        // Keeps the domain pinned while alive. Guards nest and are movable but belong to the thread that made them.
+        class guard {
+            floating_epoch_domain* _domain;
+            friend class floating_epoch_domain;
+            explicit guard(floating_epoch_domain* domain) : _domain(domain) {
+                _domain->enter(_domain->local());
+            }
+        public:
+            guard(guard&& other) noexcept : _domain(std::exchange(other._domain, nullptr)) {}
+            guard& operator=(guard&&) = delete;
+            ~guard() {
+                if(_domain) {
+                    _domain->leave(_domain->local());
+                }
+            }
+            // The slot is meaningful only for hazard pointers
+            template<typename T>
+            floating_pointer<T> protect(std::size_t, const std::atomic<floating_pointer<T>>& src) const {
+                return src.load(std::memory_order_acquire);
+            }
+            template<typename T>
+            void hold(std::size_t, floating_pointer<T>) const {}
+        };
+
+        floating_epoch_domain(const floating_epoch_domain&) = delete;
+        floating_epoch_domain& operator=(const floating_epoch_domain&) = delete;
+        static floating_epoch_domain& instance() {
+            static floating_epoch_domain* domain = new floating_epoch_domain();
+            return *domain;
+        }
+        guard pin() {
+            return guard(this);
+        }
+        // ptr must already be unreachable for threads that pin from now on
+        void retire(void* ptr, void (*deleter)(void*)) {
+            record& r = local();
+            r.retired.push_back({ptr, deleter, _epoch.load(std::memory_order_seq_cst)});
+            if(r.retired.size() >= batch_size) {
+                collect(r);
+            }
+        }
+        template<typename T>
+        void retire(floating_pointer<T> ptr) {
+            retire(static_cast<void*>(static_cast<T*>(abs(ptr))), detail::delete_object<T>);
+        }
+        // Frees what this thread can free now. Safe while pinned: this thread's own pin keeps the epoch from moving
+        // past anything it can still reach.
+        void collect() {
+            collect(local());
+        }
+        std::uint64_t epoch() const {
+            return _epoch.load(std::memory_order_relaxed);
+        }
+    };
+
+    // Hazard pointer reclamation with the same interface as floating_epoch_domain. A guard owns hazard_slots slots;
+    // protect() publishes the pointer it loads in a slot and retries until the source still holds it, so a retired
+    // node is freed only once no slot names it. Unlike epochs, a stalled thread pins at most hazard_slots nodes, but
+    // every hop of a traversal pays a store-load fence and structures must validate each hop (protects_traversal is
+    // false). Sign bits are stripped before publishing, so marked links protect their target.
+    //
+    // A thread may hold one guard at a time. There is one process-wide domain, floating_hazard_domain::instance().
+    class floating_hazard_domain {
+    public:
+        static constexpr std::size_t hazard_slots = 4;
+        static constexpr std::size_t batch_size = 64;
+        static constexpr bool protects_traversal = false;
+    private:
+        struct alignas(64) record {
+            record* next = nullptr;
+            std::atomic<bool> in_use{false};
+            std::atomic<void*> hazards[hazard_slots] = {};
+            std::vector<detail::retired_object> retired;
+        };
+        detail::record_registry<record> _records;
+        detail::orphanage _orphans;
+
+        struct thread_handle {
+            floating_hazard_domain* domain;
+            record* r;
+            explicit thread_handle(floating_hazard_domain* domain) : domain(domain), r(domain->_records.acquire()) {}
+            thread_handle(const thread_handle&) = delete;
+            thread_handle& operator=(const thread_handle&) = delete;
+            ~thread_handle() {
+                domain->scan(*r);
+                domain->_orphans.leave(r->retired);
+                domain->_records.release(r);
+            }
+        };
+        record& local() {
+            static thread_local thread_handle handle(this);
+            return *handle.r;
+        }
+
+        void scan(record& r) {
+            _orphans.adopt(r.retired);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::vector<void*> hazards;
+            _records.for_each([&](record& other) {
+                for(auto& h : other.hazards) {
+                    if(void* p = h.load(std::memory_order_seq_cst)) {
+                        hazards.push_back(p);
+                    }
+                }
+            });
+            std::sort(hazards.begin(), hazards.end());
+            auto kept = std::partition(r.retired.begin(), r.retired.end(), [&](const detail::retired_object& o) {
+                return std::binary_search(hazards.begin(), hazards.end(), o.ptr);
+            });
+            for(auto it = kept; it != r.retired.end(); ++it) {
+                it->deleter(it->ptr);
+            }
+            r.retired.erase(kept, r.retired.end());
+        }
+
+        floating_hazard_domain() = default;
+    public:
+        class guard {
+            record* _record;
+            friend class floating_hazard_domain;
+            explicit guard(record* r) : _record(r) {}
+        public:
+            guard(guard&& other) noexcept : _record(std::exchange(other._record, nullptr)) {}
+            guard& operator=(guard&&) = delete;
+            ~guard() {
+                if(_record) {
+                    for(auto& h : _record->hazards) {
+                        h.store(nullptr, std::memory_order_release);
+                    }
+                }
+            }
+            // Loads src and keeps its target alive until the slot is reused or the guard dies
+            template<typename T>
+            floating_pointer<T> protect(std::size_t slot, const std::atomic<floating_pointer<T>>& src) const {
+                floating_pointer<T> ptr = src.load(std::memory_order_relaxed);
+                for(;;) {
+                    _record->hazards[slot].store(static_cast<void*>(static_cast<T*>(abs(ptr))),
+                                                 std::memory_order_seq_cst);
+                    floating_pointer<T> again = src.load(std::memory_order_acquire);
+                    if(detail::pointer_bits(again) == detail::pointer_bits(ptr)) {
+                        return ptr;
+                    }
+                    ptr = again;
+                }
+            }
+            // Moves protection of a pointer already protected by another slot
+            template<typename T>
+            void hold(std::size_t slot, floating_pointer<T> ptr) const {
+                _record->hazards[slot].store(static_cast<void*>(static_cast<T*>(abs(ptr))), std::memory_order_release);
+            }
+        };
+
+        floating_hazard_domain(const floating_hazard_domain&) = delete;
+        floating_hazard_domain& operator=(const floating_hazard_domain&) = delete;
+        static floating_hazard_domain& instance() {
+            static floating_hazard_domain* domain = new floating_hazard_domain();
+            return *domain;
+        }
+        guard pin() {
+            return guard(&local());
+        }
+        // ptr must already be unreachable from the structure
+        void retire(void* ptr, void (*deleter)(void*)) {
+            record& r = local();
+            r.retired.push_back({ptr, deleter, 0});
+            // Scanning costs O(threads * hazard_slots), so scan only once there is that much to free
+            if(r.retired.size() >= std::max(batch_size, 2 * hazard_slots * _records.size())) {
+                scan(r);
+            }
+        }
+        template<typename T>
+        void retire(floating_pointer<T> ptr) {
+            retire(static_cast<void*>(static_cast<T*>(abs(ptr))), detail::delete_object<T>);
+        }
+        void collect() {
+            scan(local());
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef FLOATING_RELAYOUT_HPP
+#define FLOATING_RELAYOUT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "floating_arena.hpp"
+#include "floating_pointer_map.hpp"
+#include "floating_pointers.hpp"
+
+namespace based {
+    enum class relayout_order {
+        breadth_first, // level by level: suits searches that stop at shallow depths
+        depth_first // preorder, first edge first: subtrees end up contiguous
+    };
+
+    namespace detail {
+        // A link relayout follows: a finite non-null address. Sign bits and tags are carried over to the rewritten
+        // link; NaN and infinite sentinels are left alone.
+        template<typename Node>
+        bool is_relayout_link(floating_pointer<Node> link) {
+            floating_pointer<Node> target = abs(link);
+            return target != nullptr && target == target && target != floating_pointer<Node>(infinityptr);
+        }
+        template<typename Node>
+        floating_pointer<Node> relayout_target(floating_pointer<Node> link) {
+            return abs(link).untagged();
+        }
+        // link's sign and tag applied to its relocated target
+        template<typename Node>
+        floating_pointer<Node> relayout_relink(floating_pointer<Node> link, floating_pointer<Node> target) {
+            target = target.with_tag(abs(link).tag());
+            return signbit(link) ? -target : target;
+        }
+
+        // The nodes reachable from root, each once, in the order they leave the pending list: from the front when
+        // fifo, else from the back. arrange(first, last) may reorder each node's newly found children in place.
+        template<typename Node, typename Edges, typename Arrange>
+        std::vector<floating_pointer<Node>> relayout_walk(floating_pointer<Node> root, Edges& edges, bool fifo,
+                                                          Arrange arrange, floating_pointer_map<Node, Node*>& moved) {
+            std::vector<floating_pointer<Node>> visited;
+            std::deque<floating_pointer<Node>> pending{relayout_target(root)};
+            moved[relayout_target(root)] = nullptr;
+            while(!pending.empty()) {
+                floating_pointer<Node> n;
+                if(fifo) {
+                    n = pending.front();
+                    pending.pop_front();
+                } else {
+                    n = pending.back();
+                    pending.pop_back();
+                }
+                visited.push_back(n);
+                std::size_t first_child = pending.size();
+                edges(*n, [&](floating_pointer<Node>& link) {
+                    if(is_relayout_link(link) && moved.try_emplace(relayout_target(link)).second) {
+                        pending.push_back(relayout_target(link));
+                    }
+                });
+                arrange(pending.begin() + std::ptrdiff_t(first_child), pending.end());
+            }
+            return visited;
+        }
+
+        // Copies order's nodes into one contiguous block of arena in that order and rewrites their links
+        template<typename Node, typename Edges>
+        floating_pointer<Node> relayout_copy(const std::vector<floating_pointer<Node>>& order, floating_arena& arena,
+                                             Edges& edges, floating_pointer_map<Node, Node*>& moved) {
+            Node* block = static_cast<Node*>(arena.allocate(order.size() * sizeof(Node), alignof(Node)));
+            for(std::size_t i = 0; i < order.size(); i++) {
+                Node* copy = ::new(static_cast<void*>(block + i)) Node(*order[i]);
+                moved[order[i]] = copy;
+            }
+            for(std::size_t i = 0; i < order.size(); i++) {
+                edges(block[i], [&](floating_pointer<Node>& link) {
+                    if(is_relayout_link(link)) {
+                        link = relayout_relink(link, floating_pointer<Node>(moved.find(relayout_target(link))->second));
+                    }
+                });
+            }
+            return block;
+        }
+    }
+
+    // Copies every node reachable from root into one fresh contiguous block of arena, in breadth or depth first order,
+    // and rewrites the copies' links to point at each other, returning the new root. edges(Node&, f) must call
+    // f(floating_pointer<Node>&) on each of a node's links. Shared nodes and cycles are copied once. The originals are
+    // untouched; free them as they were allocated. Links, and the returned root, are rewritten with their sign bits
+    // and low tag bits intact, so deletion marks, colors and other flags kept in them survive.
+    //
+    // Node is copy constructed, and must be trivially destructible as the arena never runs destructors.
+    template<typename Node, typename Edges>
+    floating_pointer<Node> relayout(floating_pointer<Node> root, floating_arena& arena, Edges edges,
+                                    relayout_order order = relayout_order::breadth_first) {
+        static_assert(std::is_trivially_destructible<Node>::value, "floating_arena never runs destructors");
+        if(!detail::is_relayout_link(root)) {
+            return root;
+        }
+        floating_pointer_map<Node, Node*> moved;
+        bool fifo = order == relayout_order::breadth_first;
+        auto visited = detail::relayout_walk(root, edges, fifo, [&](auto first, auto last) {
+            // A stack pops the first edge first if it was pushed last
+            if(!fifo) {
+                std::reverse(first, last);
+            }
+        }, moved);
+        return detail::relayout_relink(root, detail::relayout_copy(visited, arena, edges, moved));
+    }
+
+    // Hot path relayout: depth first, but each node's children are visited hottest first, so the most travelled
+    // root-to-leaf paths are contiguous and cold subtrees are pushed towards the end. heat(const Node&) returns a
+    // profile count such as the number of times a lookup passed through the node.
+    template<typename Node, typename Edges, typename Heat,
+             typename std::enable_if<!std::is_same<typename std::decay<Heat>::type, relayout_order>::value,
+                                     int>::type = 0>
+    floating_pointer<Node> relayout(floating_pointer<Node> root, floating_arena& arena, Edges edges, Heat heat) {
+        static_assert(std::is_trivially_destructible<Node>::value, "floating_arena never runs destructors");
+        if(!detail::is_relayout_link(root)) {
+            return root;
+        }
+        floating_pointer_map<Node, Node*> moved;
+        auto visited = detail::relayout_walk(root, edges, false, [&](auto first, auto last) {
+            // Coldest first on the stack, so the hottest is popped next; ties keep the first edge first
+            std::reverse(first, last);
+            std::stable_sort(first, last, [&](floating_pointer<Node> a, floating_pointer<Node> b) {
+                return heat(*a) < heat(*b);
+            });
+        }, moved);
+        return detail::relayout_relink(root, detail::relayout_copy(visited, arena, edges, moved));
+    }
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef FLOATING_SLOT_MAP_HPP
+#define FLOATING_SLOT_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    // A generational slot map whose handles are quiet NaNs. The 51 bit payload packs a 32 bit slot index and a 19 bit
+    // generation, so a handle is 8 bytes, trivially copyable, and detects use after erase in O(1) without reference
+    // counting. The null handle is nanptr's NaN (payload 0), which no live element ever gets: generations start at 1.
+    //
+    // A slot is retired rather than reused once its generation is exhausted, so a stale handle can never alias a newer
+    // element. Like std::vector, inserting may move elements; resolve handles again after inserting.
+    template<typename T>
+    class floating_slot_map {
+        static constexpr int generation_bits = 19;
+        static constexpr std::uint32_t max_generation = (std::uint32_t(1) << generation_bits) - 1;
+        static constexpr std::uint32_t no_slot = std::uint32_t(-1);
+
+        struct slot {
+            alignas(T) unsigned char storage[sizeof(T)];
+            std::uint32_t generation = 1;
+            std::uint32_t next_free = no_slot;
+            bool occupied = false;
+            T* value() {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+            const T* value() const {
+                return std::launder(reinterpret_cast<const T*>(storage));
+            }
+        };
+
+        std::vector<slot> _slots;
+        std::uint32_t _free = no_slot;
+        std::size_t _size = 0;
+    public:
+        class handle {
+            double _value;
+            friend class floating_slot_map;
+            explicit handle(std::uint64_t payload) : _value(detail::box_nan(payload)) {}
+            std::uint32_t index() const {
+                return std::uint32_t(detail::unbox_nan(_value) >> generation_bits);
+            }
+            std::uint32_t generation() const {
+                return std::uint32_t(detail::unbox_nan(_value) & max_generation);
+            }
+        public:
+            handle() : _value(NAN) {}
+            handle(nanptr_t) : handle() {}
+            // The handle as the NaN it is, for storing alongside other doubles
+            explicit operator double() const {
+                return _value;
+            }
+            static handle from_double(double value) {
+                handle h;
+                h._value = value;
+                return h;
+            }
+            explicit operator bool() const {
+                return detail::unbox_nan(_value) != 0;
+            }
+            // NaNs never compare equal, so handles compare by payload
+            friend bool operator==(handle a, handle b) {
+                return detail::unbox_nan(a._value) == detail::unbox_nan(b._value);
+            }
+            friend bool operator!=(handle a, handle b) {
+                return !(a == b);
+            }
+        };
+
+        floating_slot_map() = default;
+        floating_slot_map(const floating_slot_map& other) : _free(other._free), _size(other._size) {
+            _slots.resize(other._slots.size());
+            for(std::size_t i = 0; i < _slots.size(); i++) {
+                _slots[i].generation = other._slots[i].generation;
+                _slots[i].next_free = other._slots[i].next_free;
+                if(other._slots[i].occupied) {
+                    ::new(static_cast<void*>(_slots[i].storage)) T(*other._slots[i].value());
+                    _slots[i].occupied = true;
+                }
+            }
+        }
+        floating_slot_map(floating_slot_map&& other) noexcept
+            : _slots(std::move(other._slots)), _free(other._free), _size(other._size) {
+            other._slots.clear();
+            other._free = no_slot;
+            other._size = 0;
+        }
+        floating_slot_map& operator=(floating_slot_map other) noexcept {
+            std::swap(_slots, other._slots);
+            std::swap(_free, other._free);
+            std::swap(_size, other._size);
+            return *this;
+        }
+        ~floating_slot_map() {
+            clear();
+        }
+
+        template<typename... Args>
+        handle emplace(Args&&... args) {
+            if(_free == no_slot) {
+                reserve(_slots.size() + 1);
+                _free = std::uint32_t(_slots.size());
+                _slots.emplace_back();
+            }
+            std::uint32_t index = _free;
+            slot& s = _slots[index];
+            ::new(static_cast<void*>(s.storage)) T(std::forward<Args>(args)...);
+            _free = s.next_free;
+            s.occupied = true;
+            _size++;
+            return handle((std::uint64_t(index) << generation_bits) | s.generation);
+        }
+        handle insert(const T& value) {
+            return emplace(value);
+        }
+        handle insert(T&& value) {
+            return emplace(std::move(value));
+        }
+
+        // Null when h is stale, null, or from another map
+        floating_pointer<T> get(handle h) {
+            std::uint32_t index = h.index();
+            if(index < _slots.size() && _slots[index].occupied && _slots[index].generation == h.generation()) {
+                return _slots[index].value();
+            }
+            return nullptr;
+        }
+        floating_pointer<const T> get(handle h) const {
+            return const_cast<floating_slot_map*>(this)->get(h);
+        }
+        bool contains(handle h) const {
+            return bool(get(h));
+        }
+
+        bool erase(handle h) {
+            if(!get(h)) {
+                return false;
+            }
+            std::uint32_t index = h.index();
+            slot& s = _slots[index];
+            s.value()->~T();
+            s.occupied = false;
+            _size--;
+            if(s.generation < max_generation) {
+                s.generation++;
+                s.next_free = _free;
+                _free = index;
+            }
+            return true;
+        }
+
+        // Destroys every element. Outstanding handles stay stale, slots keep their generations.
+        void clear() {
+            for(std::size_t i = 0; i < _slots.size(); i++) {
+                if(_slots[i].occupied) {
+                    erase(handle((std::uint64_t(i) << generation_bits) | _slots[i].generation));
+                }
+            }
+        }
+
+        void reserve(std::size_t n) {
+            if(n <= _slots.capacity()) {
+                return;
+            }
+            // Relocate by hand: a slot's storage is raw bytes as far as the vector knows
+            std::vector<slot> grown;
+            grown.reserve(n < 2 * _slots.capacity() ? 2 * _slots.capacity() : n);
+            grown.resize(_slots.size());
+            for(std::size_t i = 0; i < _slots.size(); i++) {
+                grown[i].generation = _slots[i].generation;
+                grown[i].next_free = _slots[i].next_free;
+                if(_slots[i].occupied) {
+                    ::new(static_cast<void*>(grown[i].storage)) T(std::move(*_slots[i].value()));
+                    _slots[i].value()->~T();
+                    grown[i].occupied = true;
+                }
+            }
+            _slots.swap(grown);
+        }
+        std::size_t size() const {
+            return _size;
+        }
+        bool empty() const {
+            return _size == 0;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef FLOATING_SORT_HPP
+#define FLOATING_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        constexpr std::size_t network_size = 16;
+        // Below this many elements the radix sort's histogram and scatter passes cost more than sorting networks
+        // and merging
+        constexpr std::size_t radix_threshold = 256;
+
+        inline void compare_exchange(std::uint64_t& a, std::uint64_t& b) {
+            std::uint64_t low = a < b ? a : b;
+            std::uint64_t high = a < b ? b : a;
+            a = low;
+            b = high;
+        }
+        // Batcher's odd-even merge sort of network_size keys as 63 comparators, built at compile time and unrolled
+        // into straight-line branchless min/max pairs; a loop over the table runs five times slower.
+        struct comparator_network {
+            static constexpr std::size_t size = 63;
+            std::uint8_t lo[size] = {};
+            std::uint8_t hi[size] = {};
+            constexpr comparator_network() {
+                constexpr std::size_t n = network_size;
+                std::size_t c = 0;
+                for(std::size_t p = 1; p < n; p *= 2) {
+                    for(std::size_t k = p; k >= 1; k /= 2) {
+                        for(std::size_t j = k % p; j + k < n; j += 2 * k) {
+                            for(std::size_t i = 0; i < k && i + j + k < n; i++) {
+                                if((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                                    lo[c] = std::uint8_t(i + j);
+                                    hi[c] = std::uint8_t(i + j + k);
+                                    c++;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        };
+        constexpr comparator_network batcher_network{};
+        template<std::size_t... C>
+        void apply_network(std::uint64_t* keys, std::index_sequence<C...>) {
+            (compare_exchange(keys[batcher_network.lo[C]], keys[batcher_network.hi[C]]), ...);
+        }
+        inline void sort_network(std::uint64_t* keys) {
+            apply_network(keys, std::make_index_sequence<comparator_network::size>());
+        }
+
+        // std::merge without the unpredictable branch on which side to take
+        inline void branchless_merge(const std::uint64_t* a, const std::uint64_t* a_end, const std::uint64_t* b,
+                                     const std::uint64_t* b_end, std::uint64_t* out) {
+            while(a != a_end && b != b_end) {
+                bool take_b = *b < *a;
+                *out++ = take_b ? *b : *a;
+                a += !take_b;
+                b += take_b;
+            }
+            out = std::copy(a, a_end, out);
+            std::copy(b, b_end, out);
+        }
+
+        // Sorting networks over blocks of network_size keys, then bottom-up merges into buffer and back. Both hold n
+        // rounded up to network_size; the padding sorts last. Returns whichever ended up sorted.
+        inline std::uint64_t* network_merge_sort(std::uint64_t* keys, std::uint64_t* buffer, std::size_t n) {
+            std::size_t padded = (n + network_size - 1) / network_size * network_size;
+            std::fill(keys + n, keys + padded, std::numeric_limits<std::uint64_t>::max());
+            for(std::size_t i = 0; i < padded; i += network_size) {
+                sort_network(keys + i);
+            }
+            for(std::size_t width = network_size; width < padded; width *= 2) {
+                for(std::size_t lo = 0; lo < padded; lo += 2 * width) {
+                    std::size_t mid = std::min(lo + width, padded);
+                    std::size_t hi = std::min(lo + 2 * width, padded);
+                    branchless_merge(keys + lo, keys + mid, keys + mid, keys + hi, buffer + lo);
+                }
+                std::swap(keys, buffer);
+            }
+            return keys;
+        }
+
+        // One pass of an LSD radix sort on total order keys: scatters src into dst by byte digit of the key
+        template<typename T>
+        void radix_pass(const floating_pointer<T>* src, floating_pointer<T>* dst, std::size_t n, int digit,
+                        const std::size_t* counts) {
+            std::size_t offsets[256];
+            std::size_t sum = 0;
+            for(int b = 0; b < 256; b++) {
+                offsets[b] = sum;
+                sum += counts[b];
+            }
+            int shift = 8 * digit;
+            for(std::size_t i = 0; i < n; i++) {
+                std::uint64_t key = total_order_key(pointer_bits(src[i]));
+                dst[offsets[(key >> shift) & 0xff]++] = src[i];
+            }
+        }
+    }
+
+    // Sorts floating pointers into total_order_less order, which for ordinary pointers is address order. Large arrays
+    // take an LSD radix sort on the totalOrder keys of their bits, one byte per pass; all eight histograms come from a
+    // single read and passes whose byte is the same for every element, such as the exponent and the top address bits
+    // of pointers into one heap, are skipped. It needs a scratch array as large as the input. Small arrays are cut
+    // into blocks of 16 sorted by a sorting network and merged.
+    template<typename T>
+    void floating_sort(floating_pointer<T>* first, floating_pointer<T>* last) {
+        std::size_t n = std::size_t(last - first);
+        if(n < 2) {
+            return;
+        }
+        if(n < detail::radix_threshold) {
+            std::uint64_t keys[detail::radix_threshold];
+            std::uint64_t buffer[detail::radix_threshold];
+            for(std::size_t i = 0; i < n; i++) {
+                keys[i] = detail::total_order_key(detail::pointer_bits(first[i]));
+            }
+            std::uint64_t* sorted = detail::network_merge_sort(keys, buffer, n);
+            for(std::size_t i = 0; i < n; i++) {
+                first[i] = detail::pointer_from_bits<T>(detail::total_order_bits(sorted[i]));
+            }
+            return;
+        }
+        std::vector<std::size_t> counts(8 * 256);
+        for(std::size_t i = 0; i < n; i++) {
+            std::uint64_t key = detail::total_order_key(detail::pointer_bits(first[i]));
+            for(int d = 0; d < 8; d++) {
+                counts[d * 256 + ((key >> (8 * d)) & 0xff)]++;
+            }
+        }
+        std::unique_ptr<floating_pointer<T>[]> scratch(new floating_pointer<T>[n]);
+        floating_pointer<T>* src = first;
+        floating_pointer<T>* dst = scratch.get();
+        std::uint64_t first_key = detail::total_order_key(detail::pointer_bits(first[0]));
+        for(int d = 0; d < 8; d++) {
+            if(counts[d * 256 + ((first_key >> (8 * d)) & 0xff)] == n) {
+                continue;
+            }
+            detail::radix_pass(src, dst, n, d, &counts[d * 256]);
+            std::swap(src, dst);
+        }
+        if(src != first) {
+            std::copy(src, src + n, first);
+        }
+    }
+}
+
+#endif
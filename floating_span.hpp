@@ -0,0 +1,342 @@
+#ifndef FLOATING_SPAN_HPP
+#define FLOATING_SPAN_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "floating_pointers.hpp"
+
+#ifdef __cpp_lib_ranges
+ #include <ranges>
+#endif
+
+namespace based {
+    template<typename T> class floating_span;
+    template<typename T> class floating_strided_span;
+    template<typename Span> class floating_chunk_view;
+
+    namespace detail {
+        template<typename C, typename T, typename = void>
+        struct is_contiguous_container_of : std::false_type {};
+        template<typename C, typename T>
+        struct is_contiguous_container_of<
+            C,
+            T,
+            std::void_t<decltype(std::data(std::declval<C&>())), decltype(std::size(std::declval<C&>()))>
+        > : std::integral_constant<
+                bool,
+                std::is_pointer<decltype(std::data(std::declval<C&>()))>::value
+                && std::is_convertible<
+                       typename std::remove_pointer<decltype(std::data(std::declval<C&>()))>::type(*)[],
+                       T(*)[]
+                   >::value
+            > {};
+    }
+
+    // A floating_pointer and a length. Views produced by stride, reverse and chunk are O(1) to construct, never
+    // allocate, and iterate with a single floating_pointer induction variable.
+    template<typename T>
+    class floating_span {
+        floating_pointer<T> _data;
+        std::size_t _size;
+    public:
+        using element_type = T;
+        using value_type = typename std::remove_cv<T>::type;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = floating_pointer<T>;
+        using reference = T&;
+        using iterator = floating_pointer<T>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        static constexpr std::size_t npos = std::size_t(-1);
+        constexpr floating_span() : _data(nullptr), _size(0) {}
+        constexpr floating_span(floating_pointer<T> data, std::size_t size) : _data(data), _size(size) {}
+        constexpr floating_span(floating_pointer<T> first, floating_pointer<T> last)
+            : _data(first), _size(std::size_t(last - first)) {}
+        template<std::size_t N> constexpr floating_span(T (&array)[N]) : _data(array), _size(N) {}
+        template<typename C, typename std::enable_if<detail::is_contiguous_container_of<C, T>::value, int>::type = 0>
+        constexpr floating_span(C& container) : _data(std::data(container)), _size(std::size(container)) {}
+        template<typename U, typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value, int>::type = 0>
+        constexpr floating_span(floating_span<U> other) : _data(other.data()), _size(other.size()) {}
+        // Access
+        constexpr floating_pointer<T> data() const {
+            return _data;
+        }
+        constexpr std::size_t size() const {
+            return _size;
+        }
+        constexpr std::size_t size_bytes() const {
+            return _size * sizeof(T);
+        }
+        constexpr bool empty() const {
+            return _size == 0;
+        }
+        constexpr T& operator[](std::size_t i) const {
+            return _data[std::ptrdiff_t(i)];
+        }
+        constexpr T& front() const {
+            return *_data;
+        }
+        constexpr T& back() const {
+            return _data[std::ptrdiff_t(_size) - 1];
+        }
+        constexpr iterator begin() const {
+            return _data;
+        }
+        constexpr iterator end() const {
+            return _data + _size;
+        }
+        constexpr reverse_iterator rbegin() const {
+            return reverse_iterator(end());
+        }
+        constexpr reverse_iterator rend() const {
+            return reverse_iterator(begin());
+        }
+        // Subviews
+        constexpr floating_span first(std::size_t count) const {
+            return {_data, count};
+        }
+        constexpr floating_span last(std::size_t count) const {
+            return {_data + (_size - count), count};
+        }
+        constexpr floating_span subspan(std::size_t offset, std::size_t count = npos) const {
+            return {_data + offset, count == npos ? _size - offset : count};
+        }
+        // Lazy views. stride(k) needs k != 0 and chunk(n) needs n > 0.
+        constexpr floating_strided_span<T> stride(std::ptrdiff_t k) const {
+            return floating_strided_span<T>(*this).stride(k);
+        }
+        constexpr floating_strided_span<T> reverse() const {
+            return floating_strided_span<T>(*this).reverse();
+        }
+        constexpr floating_chunk_view<floating_span> chunk(std::size_t n) const {
+            return {*this, n};
+        }
+    };
+
+    template<typename T> floating_span(floating_pointer<T>, std::size_t) -> floating_span<T>;
+    template<typename T> floating_span(floating_pointer<T>, floating_pointer<T>) -> floating_span<T>;
+    template<typename T, std::size_t N> floating_span(T (&)[N]) -> floating_span<T>;
+
+    // Every k-th element of a span, k possibly negative. The end iterator may point before the first element or far
+    // past the last one; that is fine for a floating pointer since it is never dereferenced.
+    template<typename T>
+    class floating_strided_span {
+        floating_pointer<T> _data;
+        std::size_t _size;
+        std::ptrdiff_t _stride;
+    public:
+        class iterator {
+            floating_pointer<T> _ptr;
+            std::ptrdiff_t _stride;
+        public:
+            using value_type = typename std::remove_cv<T>::type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = floating_pointer<T>;
+            using reference = T&;
+            using iterator_category = std::random_access_iterator_tag;
+            constexpr iterator() : _ptr(nullptr), _stride(1) {}
+            constexpr iterator(floating_pointer<T> ptr, std::ptrdiff_t stride) : _ptr(ptr), _stride(stride) {}
+            constexpr floating_pointer<T> base() const {
+                return _ptr;
+            }
+            constexpr T& operator*() const {
+                return *_ptr;
+            }
+            constexpr floating_pointer<T> operator->() const {
+                return _ptr;
+            }
+            constexpr T& operator[](std::ptrdiff_t i) const {
+                return _ptr[i * _stride];
+            }
+            constexpr iterator& operator++() {
+                _ptr += _stride;
+                return *this;
+            }
+            constexpr iterator& operator--() {
+                _ptr -= _stride;
+                return *this;
+            }
+            constexpr iterator operator++(int) {
+                iterator copy = *this;
+                _ptr += _stride;
+                return copy;
+            }
+            constexpr iterator operator--(int) {
+                iterator copy = *this;
+                _ptr -= _stride;
+                return copy;
+            }
+            constexpr iterator& operator+=(std::ptrdiff_t n) {
+                _ptr += n * _stride;
+                return *this;
+            }
+            constexpr iterator& operator-=(std::ptrdiff_t n) {
+                _ptr -= n * _stride;
+                return *this;
+            }
+            constexpr iterator operator+(std::ptrdiff_t n) const {
+                return {_ptr + n * _stride, _stride};
+            }
+            friend constexpr iterator operator+(std::ptrdiff_t n, iterator it) {
+                return it + n;
+            }
+            constexpr iterator operator-(std::ptrdiff_t n) const {
+                return {_ptr - n * _stride, _stride};
+            }
+            constexpr std::ptrdiff_t operator-(iterator other) const {
+                return (_ptr - other._ptr) / _stride;
+            }
+            constexpr bool operator==(iterator other) const {
+                return _ptr == other._ptr;
+            }
+            constexpr bool operator!=(iterator other) const {
+                return _ptr != other._ptr;
+            }
+            constexpr bool operator<(iterator other) const {
+                return other - *this > 0;
+            }
+            constexpr bool operator<=(iterator other) const {
+                return other - *this >= 0;
+            }
+            constexpr bool operator>(iterator other) const {
+                return other - *this < 0;
+            }
+            constexpr bool operator>=(iterator other) const {
+                return other - *this <= 0;
+            }
+        };
+        using element_type = T;
+        using value_type = typename std::remove_cv<T>::type;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        static constexpr std::size_t npos = std::size_t(-1);
+        constexpr floating_strided_span() : _data(nullptr), _size(0), _stride(1) {}
+        constexpr floating_strided_span(floating_pointer<T> data, std::size_t size, std::ptrdiff_t stride)
+            : _data(data), _size(size), _stride(stride) {}
+        constexpr floating_strided_span(floating_span<T> span) : _data(span.data()), _size(span.size()), _stride(1) {}
+        // Access
+        constexpr floating_pointer<T> data() const {
+            return _data;
+        }
+        constexpr std::size_t size() const {
+            return _size;
+        }
+        constexpr std::ptrdiff_t step() const {
+            return _stride;
+        }
+        constexpr bool empty() const {
+            return _size == 0;
+        }
+        constexpr T& operator[](std::size_t i) const {
+            return _data[std::ptrdiff_t(i) * _stride];
+        }
+        constexpr T& front() const {
+            return *_data;
+        }
+        constexpr T& back() const {
+            return (*this)[_size - 1];
+        }
+        constexpr iterator begin() const {
+            return {_data, _stride};
+        }
+        constexpr iterator end() const {
+            return {_data + std::ptrdiff_t(_size) * _stride, _stride};
+        }
+        // Subviews
+        constexpr floating_strided_span first(std::size_t count) const {
+            return {_data, count, _stride};
+        }
+        constexpr floating_strided_span last(std::size_t count) const {
+            return {_data + std::ptrdiff_t(_size - count) * _stride, count, _stride};
+        }
+        constexpr floating_strided_span subspan(std::size_t offset, std::size_t count = npos) const {
+            return {_data + std::ptrdiff_t(offset) * _stride, count == npos ? _size - offset : count, _stride};
+        }
+        // Lazy views. A negative k strides backwards from the last element; k must not be 0.
+        constexpr floating_strided_span stride(std::ptrdiff_t k) const {
+            assert(k != 0);
+            std::size_t magnitude = std::size_t(k < 0 ? -k : k);
+            std::size_t size = (_size + magnitude - 1) / magnitude;
+            return k < 0 ? reverse().stride(-k) : floating_strided_span(_data, size, _stride * k);
+        }
+        constexpr floating_strided_span reverse() const {
+            return {_size ? _data + std::ptrdiff_t(_size - 1) * _stride : _data, _size, -_stride};
+        }
+        constexpr floating_chunk_view<floating_strided_span> chunk(std::size_t n) const {
+            return {*this, n};
+        }
+    };
+
+    // Consecutive subviews of n > 0 elements, the last one possibly shorter.
+    template<typename Span>
+    class floating_chunk_view {
+        Span _span;
+        std::size_t _chunk;
+    public:
+        class iterator {
+            Span _span;
+            std::size_t _chunk;
+            std::size_t _offset;
+        public:
+            using value_type = Span;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Span;
+            using iterator_category = std::input_iterator_tag;
+            using iterator_concept = std::forward_iterator_tag;
+            constexpr iterator() : _span(), _chunk(1), _offset(0) {}
+            constexpr iterator(Span span, std::size_t chunk, std::size_t offset)
+                : _span(span), _chunk(chunk), _offset(offset) {}
+            constexpr Span operator*() const {
+                std::size_t remaining = _span.size() - _offset;
+                return _span.subspan(_offset, remaining < _chunk ? remaining : _chunk);
+            }
+            constexpr iterator& operator++() {
+                _offset += _chunk;
+                return *this;
+            }
+            constexpr iterator operator++(int) {
+                iterator copy = *this;
+                _offset += _chunk;
+                return copy;
+            }
+            constexpr bool operator==(const iterator& other) const {
+                return _offset == other._offset;
+            }
+            constexpr bool operator!=(const iterator& other) const {
+                return _offset != other._offset;
+            }
+        };
+        constexpr floating_chunk_view(Span span, std::size_t chunk) : _span(span), _chunk(chunk) {
+            assert(chunk > 0);
+        }
+        constexpr std::size_t size() const {
+            return (_span.size() + _chunk - 1) / _chunk;
+        }
+        constexpr bool empty() const {
+            return _span.empty();
+        }
+        constexpr Span operator[](std::size_t i) const {
+            return *iterator(_span, _chunk, i * _chunk);
+        }
+        constexpr iterator begin() const {
+            return {_span, _chunk, 0};
+        }
+        constexpr iterator end() const {
+            return {_span, _chunk, size() * _chunk};
+        }
+    };
+}
+
+#ifdef __cpp_lib_ranges
+template<typename T> inline constexpr bool std::ranges::enable_borrowed_range<based::floating_span<T>> = true;
+template<typename T> inline constexpr bool std::ranges::enable_view<based::floating_span<T>> = true;
+template<typename T> inline constexpr bool std::ranges::enable_borrowed_range<based::floating_strided_span<T>> = true;
+template<typename T> inline constexpr bool std::ranges::enable_view<based::floating_strided_span<T>> = true;
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef FLOATING_TREIBER_STACK_HPP
+#define FLOATING_TREIBER_STACK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    namespace detail {
+        // A node index and an ABA version counter NaN-boxed into one double: the index takes the low index_bits of the
+        // payload and the version the rest. Swapping a whole tagged_index with a single 64 bit compare-and-swap and
+        // bumping the version on every swap stops a stalled thread's swap from succeeding after the node it read was
+        // popped and pushed back, without double-width CAS. Comparison is bitwise, NaNs being what they are.
+        class tagged_index {
+            double _value;
+        public:
+            static constexpr int index_bits = 26;
+            static constexpr int version_bits = nan_payload_bits - index_bits;
+            static constexpr std::uint32_t null = (std::uint32_t(1) << index_bits) - 1;
+            static constexpr std::uint32_t version_mask = (std::uint32_t(1) << version_bits) - 1;
+            tagged_index() : tagged_index(null, 0) {}
+            tagged_index(std::uint32_t index, std::uint32_t version)
+                : _value(box_nan((std::uint64_t(version & version_mask) << index_bits) | index)) {}
+            std::uint32_t index() const {
+                return std::uint32_t(unbox_nan(_value) & null);
+            }
+            std::uint32_t version() const {
+                return std::uint32_t(unbox_nan(_value) >> index_bits);
+            }
+            // The same version plus one, pointing at index
+            tagged_index next(std::uint32_t index) const {
+                return tagged_index(index, version() + 1);
+            }
+            friend bool operator==(tagged_index a, tagged_index b) {
+                return to_bits(a._value) == to_bits(b._value);
+            }
+            friend bool operator!=(tagged_index a, tagged_index b) {
+                return !(a == b);
+            }
+        };
+        static_assert(sizeof(tagged_index) == sizeof(double));
+
+        // Fixed storage for the nodes of a lock-free container, with a Treiber stack of free node indices threaded
+        // through the nodes' next links. Nodes are never returned to the system while the pool lives, so a thread that
+        // reads a node after it was recycled sees a stale link, never freed memory, and its swap fails on the version.
+        template<typename T>
+        class index_pool {
+        public:
+            struct node {
+                T value;
+                std::atomic<tagged_index> next;
+            };
+        private:
+            std::unique_ptr<node[]> _nodes;
+            std::size_t _capacity;
+            std::atomic<tagged_index> _free{tagged_index()};
+            // Validated before the node array is allocated, so an oversized capacity reports length_error rather
+            // than attempting the allocation
+            static std::size_t checked(std::size_t capacity) {
+                if(capacity >= tagged_index::null) {
+                    throw std::length_error("index_pool capacity exceeds the index bits");
+                }
+                return capacity;
+            }
+        public:
+            explicit index_pool(std::size_t capacity) : _nodes(new node[checked(capacity)]), _capacity(capacity) {
+                for(std::size_t i = 0; i < capacity; i++) {
+                    _nodes[i].next.store(tagged_index(i + 1 < capacity ? std::uint32_t(i + 1) : tagged_index::null, 0),
+                                         std::memory_order_relaxed);
+                }
+                _free.store(tagged_index(capacity ? 0 : tagged_index::null, 0), std::memory_order_relaxed);
+            }
+            node& operator[](std::uint32_t index) {
+                return _nodes[index];
+            }
+            const node& operator[](std::uint32_t index) const {
+                return _nodes[index];
+            }
+            std::size_t capacity() const {
+                return _capacity;
+            }
+            // The node's link keeps its version climbing, which floating_ms_queue relies on across reuses
+            void push(std::atomic<tagged_index>& head, std::uint32_t index) {
+                tagged_index old = head.load(std::memory_order_relaxed);
+                tagged_index link = _nodes[index].next.load(std::memory_order_relaxed);
+                do {
+                    link = link.next(old.index());
+                    _nodes[index].next.store(link, std::memory_order_relaxed);
+                } while(!head.compare_exchange_weak(old, old.next(index), std::memory_order_release,
+                                                    std::memory_order_relaxed));
+            }
+            // tagged_index::null when the stack is empty
+            std::uint32_t pop(std::atomic<tagged_index>& head) {
+                tagged_index old = head.load(std::memory_order_acquire);
+                while(old.index() != tagged_index::null) {
+                    std::uint32_t next = _nodes[old.index()].next.load(std::memory_order_relaxed).index();
+                    if(head.compare_exchange_weak(old, old.next(next), std::memory_order_acquire,
+                                                  std::memory_order_acquire)) {
+                        return old.index();
+                    }
+                }
+                return tagged_index::null;
+            }
+            std::uint32_t allocate() {
+                return pop(_free);
+            }
+            void deallocate(std::uint32_t index) {
+                push(_free, index);
+            }
+        };
+    }
+
+    // A bounded lock-free multi-producer multi-consumer stack (Treiber's). Its head is a NaN-boxed node index and ABA
+    // version, swapped with an ordinary 64 bit compare-and-swap. Nodes come from a pool fixed at construction; push
+    // fails when it is exhausted. T must be trivially copyable, as with boost::lockfree.
+    template<typename T>
+    class floating_treiber_stack {
+        static_assert(std::is_trivially_copyable<T>::value, "floating_treiber_stack needs a trivially copyable T");
+        detail::index_pool<T> _pool;
+        std::atomic<detail::tagged_index> _head{detail::tagged_index()};
+    public:
+        using value_type = T;
+        // capacity must be below 2^26 - 1
+        explicit floating_treiber_stack(std::size_t capacity) : _pool(capacity) {}
+        floating_treiber_stack(const floating_treiber_stack&) = delete;
+        floating_treiber_stack& operator=(const floating_treiber_stack&) = delete;
+        // False when full
+        bool push(const T& value) {
+            std::uint32_t index = _pool.allocate();
+            if(index == detail::tagged_index::null) {
+                return false;
+            }
+            _pool[index].value = value;
+            _pool.push(_head, index);
+            return true;
+        }
+        // False when empty
+        bool pop(T& value) {
+            std::uint32_t index = _pool.pop(_head);
+            if(index == detail::tagged_index::null) {
+                return false;
+            }
+            value = _pool[index].value;
+            _pool.deallocate(index);
+            return true;
+        }
+        // A snapshot, possibly stale by the time it returns
+        bool empty() const {
+            return _head.load(std::memory_order_acquire).index() == detail::tagged_index::null;
+        }
+        std::size_t capacity() const {
+            return _pool.capacity();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef FLOATING_VALUE_HPP
+#define FLOATING_VALUE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "floating_pointers.hpp"
+
+namespace based {
+    // An 8 byte NaN-boxed value: either a double or a tagged floating_pointer to a heap object.
+    //
+    // Pointers live in quiet NaNs with a nonzero tag in payload bits 48-50 and the address in bits 0-47, so the boxed
+    // bit patterns are exactly those above 0x7ff8ffffffffffff as a signed 64 bit integer and telling them apart from
+    // numbers is one comparison. Numbers are stored as is, except that NaNs are canonicalized on the way in so that no
+    // number can look like a pointer.
+    class floating_value {
+        double _value;
+        static constexpr std::int64_t max_number_bits = detail::quiet_nan_bits | detail::boxed_address_mask;
+        explicit floating_value(double boxed, int) : _value(boxed) {}
+        std::uint64_t bits() const {
+            return detail::to_bits(_value);
+        }
+        template<typename T, typename Repr>
+        static double box(floating_pointer<T, Repr> ptr, unsigned tag) {
+            if(tag < 1 || tag > max_tag) {
+                throw std::invalid_argument("floating_value tags are 1 through max_tag");
+            }
+            // box_tagged rejects addresses wider than 48 bits
+            return detail::box_tagged(std::uintptr_t(ptr), tag);
+        }
+    public:
+        // Tags 1 through max_tag name pointer kinds; 0 is reserved for numbers
+        static constexpr unsigned max_tag = detail::boxed_max_tag;
+        floating_value() : _value(0) {}
+        floating_value(double number) : _value(number == number ? number : double(NAN)) {}
+        // Throws invalid_argument unless tag is 1 through max_tag: tag 0 would read back as a NaN number and larger
+        // tags would spill into the exponent. Throws out_of_range if the address does not fit in 48 bits.
+        template<typename T, typename Repr>
+        floating_value(floating_pointer<T, Repr> ptr, unsigned tag) : floating_value(box(ptr, tag), 0) {}
+        bool is_number() const {
+            return std::int64_t(bits()) <= max_number_bits;
+        }
+        bool is_pointer() const {
+            return !is_number();
+        }
+        // 0 for numbers
+        unsigned tag() const {
+            return is_number() ? 0 : detail::unbox_tag(_value);
+        }
+        bool has_tag(unsigned t) const {
+            return (bits() >> detail::boxed_tag_shift) == ((detail::quiet_nan_bits >> detail::boxed_tag_shift) | t);
+        }
+        double as_number() const {
+            return _value;
+        }
+        template<typename T>
+        floating_pointer<T> as_pointer() const {
+            return reinterpret_cast<T*>(detail::unbox_address(_value));
+        }
+        // Raw bits, for hashing or identity comparisons
+        std::uint64_t raw_bits() const {
+            return bits();
+        }
+
+        // Calls f(double) for numbers and f(floating_pointer<Ts...[tag - 1]>) for pointers, dispatching through a
+        // table indexed by tag. Ts must name between one and max_tag pointee types; pointers whose tag has no type are
+        // visited as numbers, so f sees a NaN.
+        template<typename... Ts, typename F>
+        decltype(auto) visit(F&& f) const {
+            static_assert(sizeof...(Ts) >= 1 && sizeof...(Ts) <= max_tag, "one pointee type per tag");
+            return visit_impl<Ts...>(std::forward<F>(f), std::index_sequence_for<Ts...>{});
+        }
+    private:
+        template<typename... Ts, typename F, std::size_t... I>
+        decltype(auto) visit_impl(F&& f, std::index_sequence<I...>) const {
+            using result = decltype(f(0.0));
+            using entry = result (*)(F&, const floating_value&);
+            static constexpr entry table[] = {
+                [](F& f, const floating_value& v) -> result { return f(v.as_number()); },
+                [](F& f, const floating_value& v) -> result { return f(v.as_pointer<Ts>()); }...
+            };
+            unsigned t = tag();
+            return table[t <= sizeof...(Ts) ? t : 0](f, *this);
+        }
+    };
+
+    static_assert(sizeof(floating_value) == sizeof(double));
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef FLOATING_POINTERS_TEST_HPP
+#define FLOATING_POINTERS_TEST_HPP
+
+// Minimal support shared by the test executables: a check macro that survives NDEBUG, and ways to check that a
+// precondition assert fires or an exception is thrown.
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+ #include <sys/wait.h>
+ #include <unistd.h>
+#endif
+
+#define CHECK(condition) \
+    do { \
+        if(!(condition)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::exit(1); \
+        } \
+    } while(false)
+
+namespace test {
+    // Runs f in a child process and reports whether it aborted, as a failed assert does. Always true where fork is
+    // unavailable, or when asserts are compiled out.
+    template<typename F>
+    bool aborts(F f) {
+        #if (defined(__unix__) || defined(__APPLE__)) && !defined(NDEBUG)
+        std::fflush(nullptr);
+        pid_t child = fork();
+        if(child == 0) {
+            // Keep the expected assertion message out of the test log
+            std::freopen("/dev/null", "w", stderr);
+            f();
+            std::_Exit(0);
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+        return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+        #else
+        (void)f;
+        return true;
+        #endif
+    }
+
+    // Whether f throws an E
+    template<typename E, typename F>
+    bool throws(F f) {
+        try {
+            f();
+        } catch(const E&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+#endif
@@ -0,0 +1,54 @@
+// floating_arena: release and rebuild cycles request the same chunk sizes from upstream every time.
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <floating_arena.hpp>
+
+#include "test.hpp"
+
+namespace {
+    // Forwards to new/delete and records the bytes of every allocation
+    class counting_resource : public std::pmr::memory_resource {
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            requested += bytes;
+            largest = bytes > largest ? bytes : largest;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    public:
+        std::size_t requested = 0;
+        std::size_t largest = 0;
+    };
+}
+
+int main() {
+    counting_resource upstream;
+    based::floating_arena arena(64 * 1024, &upstream);
+    // One small object per cycle
+    for(int cycle = 0; cycle < 12; cycle++) {
+        upstream.requested = 0;
+        *arena.make<int>() = cycle;
+        CHECK(upstream.requested == 64 * 1024);
+        arena.release();
+    }
+    // Enough objects per cycle to take several chunks
+    std::size_t first_cycle = 0;
+    for(int cycle = 0; cycle < 12; cycle++) {
+        upstream.requested = 0;
+        for(int i = 0; i < 100000; i++) {
+            *arena.make<double>() = i;
+        }
+        if(cycle == 0) {
+            first_cycle = upstream.requested;
+        }
+        CHECK(upstream.requested == first_cycle);
+        arena.release();
+    }
+    CHECK(upstream.largest < 1024 * 1024);
+}
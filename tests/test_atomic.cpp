@@ -0,0 +1,68 @@
+// std::atomic<floating_pointer>: compare-and-swap works on bit patterns and fetch_add from many threads loses no
+// increments. Meant to be run under -fsanitize=thread.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <floating_atomic.hpp>
+
+#include "test.hpp"
+
+using based::floating_pointer;
+
+int main() {
+    static int array[1 << 16];
+    floating_pointer<int> first = &array[0];
+
+    std::atomic<floating_pointer<int>> a(first);
+    CHECK(a.is_lock_free() == std::atomic<std::uint64_t>().is_lock_free());
+    CHECK(a.load() == first);
+    CHECK(a.exchange(first + 5) == first && a.load() == first + 5);
+    a += 3;
+    CHECK(a.load() == first + 8);
+    CHECK(a-- == first + 8 && --a == first + 6 && ++a == first + 7);
+
+    // Bit patterns, not values: negativenullptr does not match nullptr, and a NaN matches itself
+    std::atomic<floating_pointer<int>> null(nullptr);
+    floating_pointer<int> expected = based::negativenullptr;
+    CHECK(!null.compare_exchange_strong(expected, first));
+    CHECK(based::detail::pointer_bits(expected) == based::detail::pointer_bits(floating_pointer<int>(nullptr)));
+    CHECK(null.compare_exchange_strong(expected, based::nanptr));
+    expected = based::nanptr;
+    CHECK(null.compare_exchange_strong(expected, first) && null.load() == first);
+
+    // Concurrent fetch_add and compare-and-swap increments all land
+    constexpr unsigned threads = 4;
+    constexpr int steps = 4000;
+    std::atomic<floating_pointer<int>> cursor(first);
+    std::vector<std::thread> workers;
+    for(unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for(int i = 0; i < steps; i++) {
+                if(t % 2) {
+                    cursor.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    floating_pointer<int> old = cursor.load(std::memory_order_relaxed);
+                    while(!cursor.compare_exchange_weak(old, old + 2, std::memory_order_acq_rel)) {}
+                }
+            }
+        });
+    }
+    for(auto& w : workers) {
+        w.join();
+    }
+    CHECK(cursor.load() == first + (threads / 2) * steps * 3);
+
+    // Message passing through a release store and an acquire load
+    int payload = 0;
+    std::atomic<floating_pointer<int>> message(nullptr);
+    std::thread producer([&] {
+        payload = 42;
+        message.store(&payload, std::memory_order_release);
+    });
+    floating_pointer<int> received;
+    while(!(received = message.load(std::memory_order_acquire))) {}
+    CHECK(*received == 42);
+    producer.join();
+}
@@ -0,0 +1,140 @@
+// floating_btree_set: random inserts and erases agree with std::set across node splits and merges, and the node rank
+// kernel agrees with a scalar count. tests/CMakeLists.txt builds this once per SIMD instruction set the compiler can
+// target, so each rank path is checked.
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <floating_btree_set.hpp>
+
+#include "test.hpp"
+
+using based::floating_btree_set;
+using based::floating_pointer;
+
+namespace {
+    // CTest's SKIP_RETURN_CODE, for builds whose instructions this CPU lacks
+    constexpr int skipped = 77;
+
+    bool cpu_supported() {
+        #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        #if defined(__AVX512F__)
+        return __builtin_cpu_supports("avx512f");
+        #elif defined(__AVX__)
+        return __builtin_cpu_supports("avx");
+        #elif defined(__SSE2__)
+        return __builtin_cpu_supports("sse2");
+        #endif
+        #endif
+        return true;
+    }
+
+    bool same(const floating_btree_set<int>& set, const std::set<int*>& reference) {
+        if(set.size() != reference.size()) {
+            return false;
+        }
+        auto it = reference.begin();
+        for(floating_pointer<int> p : set) {
+            if(it == reference.end() || static_cast<int*>(p) != *it) {
+                return false;
+            }
+            ++it;
+        }
+        return it == reference.end();
+    }
+}
+
+int main() {
+    if(!cpu_supported()) {
+        return skipped;
+    }
+    static int objects[4096];
+    std::mt19937_64 random(7);
+    auto next = [&](std::size_t range) {
+        return std::size_t(random() % range);
+    };
+
+    // The kernel on its own: every count, both bounds, keys below, between, on and above the node's keys
+    alignas(64) floating_pointer<int> keys[based::detail::btree_width];
+    for(unsigned count = 0; count <= based::detail::btree_width; count++) {
+        for(unsigned i = 0; i < based::detail::btree_width; i++) {
+            keys[i] = i < count ? &objects[2 * i + 1] : &objects[4000 + i];
+        }
+        for(unsigned k = 0; k < 2 * based::detail::btree_width + 2; k++) {
+            floating_pointer<int> key = &objects[k];
+            unsigned less = 0;
+            unsigned not_greater = 0;
+            for(unsigned i = 0; i < count; i++) {
+                less += keys[i] < key;
+                not_greater += keys[i] <= key;
+            }
+            CHECK(based::detail::btree_rank<false>(keys, count, key) == less);
+            CHECK(based::detail::btree_rank<true>(keys, count, key) == not_greater);
+        }
+    }
+
+    // Growth phases split nodes up to several levels, shrink phases merge and borrow back down to empty
+    floating_btree_set<int> set;
+    std::set<int*> reference;
+    for(int phase = 0; phase < 6; phase++) {
+        bool grow = phase % 2 == 0;
+        std::size_t target = grow ? 2500 : 0;
+        while(grow ? reference.size() < target : !reference.empty()) {
+            int* p = &objects[next(4096)];
+            if(next(100) < (grow ? 75u : 25u)) {
+                CHECK(set.insert(p).second == reference.insert(p).second);
+            } else if(grow || next(2)) {
+                CHECK(set.erase(p) == reference.erase(p));
+            } else {
+                // Erase an element that is present so that shrinking reaches empty
+                auto it = set.lower_bound(p);
+                if(it == set.end()) {
+                    it = set.begin();
+                }
+                CHECK(reference.erase(static_cast<int*>(*it)) == 1);
+                set.erase(it);
+            }
+            int* probe = &objects[next(4096)];
+            CHECK(set.contains(probe) == (reference.count(probe) == 1));
+            auto lower = set.lower_bound(probe);
+            auto expected = reference.lower_bound(probe);
+            CHECK(expected == reference.end() ? lower == set.end() : static_cast<int*>(*lower) == *expected);
+            auto upper = set.upper_bound(probe);
+            expected = reference.upper_bound(probe);
+            CHECK(expected == reference.end() ? upper == set.end() : static_cast<int*>(*upper) == *expected);
+            if(reference.size() % 97 == 0) {
+                CHECK(same(set, reference));
+            }
+        }
+        CHECK(same(set, reference));
+    }
+    CHECK(set.empty() && set.begin() == set.end());
+
+    // Sequential inserts always split the rightmost leaf; erasing through iterators walks the leaf chain
+    for(int i = 0; i < 2000; i++) {
+        set.insert(&objects[i]);
+        reference.insert(&objects[i]);
+    }
+    floating_btree_set<int> copy = set;
+    CHECK(same(copy, reference));
+    for(auto it = set.begin(); it != set.end();) {
+        it = set.erase(it);
+        if(it != set.end()) {
+            ++it;
+        }
+    }
+    for(auto it = reference.begin(); it != reference.end();) {
+        it = reference.erase(it);
+        if(it != reference.end()) {
+            ++it;
+        }
+    }
+    CHECK(same(set, reference));
+    CHECK(copy.size() == 2000 && copy.contains(&objects[1]));
+    floating_btree_set<int> moved = std::move(copy);
+    CHECK(copy.empty() && moved.size() == 2000);
+}
@@ -0,0 +1,105 @@
+// floating_csr_graph: parallel BFS and PageRank agree with serial references over many levels and iterations.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <floating_csr_graph.hpp>
+
+#include "test.hpp"
+
+using based::floating_bfs;
+using based::floating_csr_graph;
+using based::floating_pagerank;
+
+namespace {
+    using graph = floating_csr_graph<std::uint32_t>;
+
+    std::vector<std::size_t> depths(const graph& g, std::uint32_t source) {
+        std::vector<std::size_t> depth(g.vertex_count(), SIZE_MAX);
+        std::queue<std::uint32_t> queue;
+        depth[source] = 0;
+        queue.push(source);
+        while(!queue.empty()) {
+            std::uint32_t u = queue.front();
+            queue.pop();
+            for(std::uint32_t w : g.neighbors(u)) {
+                if(depth[w] == SIZE_MAX) {
+                    depth[w] = depth[u] + 1;
+                    queue.push(w);
+                }
+            }
+        }
+        return depth;
+    }
+
+    // Parents must form a BFS tree: every reached vertex sits one level below its parent, along an edge
+    bool valid_tree(const graph& g, std::uint32_t source, const std::vector<std::uint32_t>& parent) {
+        std::vector<std::size_t> depth = depths(g, source);
+        for(std::size_t v = 0; v < g.vertex_count(); v++) {
+            if(depth[v] == SIZE_MAX || v == source) {
+                if(parent[v] != (v == source ? source : graph::no_vertex)) {
+                    return false;
+                }
+                continue;
+            }
+            std::uint32_t p = parent[v];
+            if(p == graph::no_vertex || depth[p] + 1 != depth[v]) {
+                return false;
+            }
+            bool edge = false;
+            for(std::uint32_t w : g.neighbors(p)) {
+                edge |= w == v;
+            }
+            if(!edge) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    // A long path, so BFS runs thousands of levels, with random shortcuts so some levels are wide
+    const std::size_t n = 20000;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+    std::uint64_t state = 12345;
+    for(std::uint32_t v = 0; v + 1 < n; v++) {
+        edges.emplace_back(v, v + 1);
+        edges.emplace_back(v + 1, v);
+    }
+    for(std::size_t i = 0; i < 3 * n; i++) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        std::uint32_t a = std::uint32_t((state >> 33) % 5000);
+        std::uint32_t b = std::uint32_t((state >> 13) % 5000);
+        edges.emplace_back(a, b);
+        edges.emplace_back(b, a);
+    }
+    graph g(n, edges);
+    for(unsigned threads : {1u, 2u, 4u, 16u}) {
+        CHECK(valid_tree(g, 0, floating_bfs(g, 0, threads)));
+        CHECK(valid_tree(g, std::uint32_t(n - 1), floating_bfs(g, std::uint32_t(n - 1), threads)));
+    }
+    graph tiny(3, {{0, 1}, {1, 2}});
+    CHECK(valid_tree(tiny, 0, floating_bfs(tiny, tiny.transpose(), 0, 8)));
+
+    std::vector<double> serial = floating_pagerank(g, 30, 0.85, 1);
+    std::vector<double> parallel = floating_pagerank(g, 30, 0.85, 8);
+    double sum = 0;
+    bool same = true;
+    for(std::size_t v = 0; v < n; v++) {
+        sum += parallel[v];
+        same &= std::fabs(serial[v] - parallel[v]) < 1e-12;
+    }
+    CHECK(same);
+    CHECK(std::fabs(sum - 1) < 1e-9);
+    CHECK(floating_pagerank(graph()).empty());
+
+    // Endpoints past vertex_count would write outside the edge buffer or leave BFS a dangling neighbor
+    CHECK(test::aborts([] { graph bad(3, {{0, 1}, {3, 0}}); }));
+    CHECK(test::aborts([] { graph bad(3, {{0, 1}, {1, 3}}); }));
+    CHECK(test::aborts([] { graph bad(0, {{0, 0}}); }));
+}
@@ -0,0 +1,95 @@
+// floating_harris_set: concurrent inserts, erases and lookups under both reclaimers leave exactly the keys a serial
+// replay predicts, and contended keys are inserted and erased exactly once. Meant to be run under -fsanitize=thread.
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <floating_harris_set.hpp>
+
+#include "test.hpp"
+
+using based::floating_epoch_domain;
+using based::floating_harris_set;
+using based::floating_hazard_domain;
+
+namespace {
+    constexpr unsigned threads = 4;
+    constexpr int keys = 512;
+    constexpr int operations = 20000;
+
+    template<typename Reclaimer>
+    void run() {
+        floating_harris_set<int, std::less<int>, Reclaimer> set;
+
+        // Each thread updates the keys equal to its index mod threads, so its own serial replay predicts the final
+        // contents, while its nodes interleave with everyone else's in the list
+        std::vector<std::set<int>> expected(threads);
+        std::vector<std::thread> workers;
+        for(unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                std::mt19937 random(t);
+                for(int i = 0; i < operations; i++) {
+                    int key = int(random() % (keys / threads)) * int(threads) + int(t);
+                    int other = int(random() % keys);
+                    switch(random() % 3) {
+                        case 0:
+                            CHECK(set.insert(key) == expected[t].insert(key).second);
+                            break;
+                        case 1:
+                            CHECK(set.erase(key) == (expected[t].erase(key) == 1));
+                            break;
+                        default:
+                            CHECK(set.contains(key) == (expected[t].count(key) == 1));
+                            set.contains(other);
+                            break;
+                    }
+                }
+            });
+        }
+        for(auto& w : workers) {
+            w.join();
+        }
+        std::set<int> all;
+        for(const auto& e : expected) {
+            all.insert(e.begin(), e.end());
+        }
+        std::vector<int> found;
+        set.for_each([&](int k) { found.push_back(k); });
+        CHECK(found == std::vector<int>(all.begin(), all.end()));
+
+        // Every thread races for the same keys: each insert and each erase succeeds in exactly one thread. The erases
+        // wait for all the inserts, or a late insert could add a key back after it was erased.
+        std::atomic<int> inserted{0};
+        std::atomic<int> erased{0};
+        for(bool erasing : {false, true}) {
+            workers.clear();
+            for(unsigned t = 0; t < threads; t++) {
+                workers.emplace_back([&] {
+                    for(int key = keys; key < 2 * keys; key++) {
+                        if(erasing) {
+                            erased += set.erase(key);
+                        } else {
+                            inserted += set.insert(key);
+                        }
+                    }
+                });
+            }
+            for(auto& w : workers) {
+                w.join();
+            }
+        }
+        CHECK(inserted == keys && erased == keys);
+        found.clear();
+        set.for_each([&](int k) { found.push_back(k); });
+        CHECK(found == std::vector<int>(all.begin(), all.end()));
+    }
+}
+
+int main() {
+    run<floating_epoch_domain>();
+    run<floating_hazard_domain>();
+}
@@ -0,0 +1,51 @@
+// floating_heap: blocks can be allocated and freed after the calling thread's cache is destroyed, from static
+// destructors and from thread_local destructors that run after the cache's.
+
+#include <thread>
+
+#include <floating_heap.hpp>
+
+#include "test.hpp"
+
+using based::floating_heap;
+using based::floating_pointer;
+
+namespace {
+    struct node {
+        double payload[3];
+    };
+
+    // Frees its node, then allocates and frees another, when destroyed
+    struct holder {
+        floating_pointer<node> n = nullptr;
+        ~holder() {
+            floating_heap& heap = floating_heap::instance();
+            heap.destroy(n);
+            floating_pointer<node> again = heap.make<node>();
+            again->payload[0] = 1;
+            heap.destroy(again);
+        }
+    };
+
+    // Destroyed after main's thread_local objects, the heap's cache among them
+    holder static_holder;
+}
+
+int main() {
+    floating_heap& heap = floating_heap::instance();
+    static_holder.n = heap.make<node>();
+
+    std::thread worker([] {
+        // Constructed before the thread's cache, so destroyed after it
+        thread_local holder late;
+        late.n = floating_heap::instance().make<node>();
+        floating_pointer<node> n = floating_heap::instance().make<node>();
+        floating_heap::instance().destroy(n);
+    });
+    worker.join();
+
+    floating_pointer<node> n = heap.make<node>();
+    n->payload[0] = 2;
+    CHECK(n->payload[0] == 2);
+    heap.destroy(n);
+}
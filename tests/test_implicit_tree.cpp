@@ -0,0 +1,104 @@
+// floating_implicit_tree: Eytzinger and van Emde Boas searches agree with std::lower_bound for every size up to a few
+// hundred, complete trees and the padded ones between them alike, and from_tree copies a pointer tree in order.
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <floating_implicit_tree.hpp>
+
+#include "test.hpp"
+
+using based::floating_implicit_tree;
+using based::floating_pointer;
+using based::implicit_layout;
+
+namespace {
+    using tree = floating_implicit_tree<int, int>;
+
+    // Every key of sorted, every gap around them and both ends
+    bool searches_like_std(const tree& t, const std::vector<std::pair<int, int>>& sorted) {
+        if(t.size() != sorted.size() || t.empty() != sorted.empty()) {
+            return false;
+        }
+        int last = sorted.empty() ? 0 : sorted.back().first;
+        for(int key = -2; key <= last + 2; key++) {
+            auto it = std::lower_bound(sorted.begin(), sorted.end(), key,
+                                       [](const std::pair<int, int>& e, int k) { return e.first < k; });
+            auto [found_key, found_value] = t.lower_bound(key);
+            if(it == sorted.end()) {
+                if(found_key || found_value || t.find(key)) {
+                    return false;
+                }
+                continue;
+            }
+            if(!found_key || *found_key != it->first) {
+                return false;
+            }
+            bool present = it->first == key;
+            const int* value = t.find(key);
+            if(present != (value != nullptr) || present != t.contains(key)) {
+                return false;
+            }
+            // With distinct keys the value must be the one stored with the key
+            bool distinct = std::next(it) == sorted.end() || std::next(it)->first != it->first;
+            if(distinct && (*found_value != it->second || (value && *value != it->second))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct node {
+        int key;
+        floating_pointer<node> left;
+        floating_pointer<node> right;
+    };
+}
+
+int main() {
+    for(implicit_layout layout : {implicit_layout::eytzinger, implicit_layout::van_emde_boas}) {
+        // Odd keys, so every even key is a miss between two of them
+        for(int n = 0; n <= 300; n++) {
+            std::vector<std::pair<int, int>> sorted;
+            for(int i = 0; i < n; i++) {
+                sorted.emplace_back(2 * i + 1, 1000 + i);
+            }
+            tree t(sorted, layout);
+            CHECK(t.layout() == layout);
+            CHECK(searches_like_std(t, sorted));
+        }
+        // Runs of equal keys, which find the first of the run
+        for(int n : {1, 2, 3, 7, 8, 31, 100, 255, 256}) {
+            std::vector<std::pair<int, int>> sorted;
+            for(int i = 0; i < n; i++) {
+                sorted.emplace_back(i / 3, i);
+            }
+            CHECK(searches_like_std(tree(sorted, layout), sorted));
+        }
+        CHECK(tree().empty() && !tree().find(0) && !tree().lower_bound(0).first);
+
+        // A degenerate (right leaning) pointer tree and a balanced one copy into the same sorted order
+        std::vector<node> chain(40);
+        for(int i = 0; i < 40; i++) {
+            chain[i] = {i * 10, nullptr, i + 1 < 40 ? floating_pointer<node>(&chain[i + 1]) : nullptr};
+        }
+        node balanced[7] = {{30, &balanced[1], &balanced[2]}, {10, &balanced[3], &balanced[4]},
+                            {50, &balanced[5], &balanced[6]}, {0, nullptr, nullptr}, {20, nullptr, nullptr},
+                            {40, nullptr, nullptr}, {60, nullptr, nullptr}};
+        auto key = [](const node& n) { return n.key; };
+        auto value = [](const node& n) { return -n.key; };
+        tree from_chain = tree::from_tree(floating_pointer<node>(&chain[0]), key, value, layout);
+        tree from_balanced = tree::from_tree(floating_pointer<node>(&balanced[0]), key, value, layout);
+        std::vector<std::pair<int, int>> expected;
+        for(int i = 0; i < 40; i++) {
+            expected.emplace_back(i * 10, -i * 10);
+        }
+        CHECK(searches_like_std(from_chain, expected));
+        expected.resize(7);
+        CHECK(searches_like_std(from_balanced, expected));
+        CHECK(tree::from_tree(floating_pointer<node>(nullptr), key, value, layout).empty());
+    }
+}
@@ -0,0 +1,88 @@
+// floating_treiber_stack and floating_ms_queue: with several producers and consumers every pushed value is popped
+// exactly once, push fails when full and pop when empty, and oversized capacities are rejected before allocating.
+// Meant to be run under -fsanitize=thread.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <floating_ms_queue.hpp>
+#include <floating_treiber_stack.hpp>
+
+#include "test.hpp"
+
+using based::floating_ms_queue;
+using based::floating_treiber_stack;
+
+namespace {
+    constexpr unsigned producers = 3;
+    constexpr unsigned consumers = 3;
+    constexpr std::uint32_t per_producer = 20000;
+
+    template<typename Container>
+    void run() {
+        // Single threaded: the exact capacity fits, then push fails; pop fails once drained
+        Container small(4);
+        CHECK(small.empty());
+        std::uint32_t value = 0;
+        CHECK(!small.pop(value));
+        for(std::uint32_t i = 0; i < 4; i++) {
+            CHECK(small.push(i));
+        }
+        CHECK(!small.push(4) && !small.empty());
+        for(std::uint32_t i = 0; i < 4; i++) {
+            CHECK(small.pop(value) && value < 4);
+        }
+        CHECK(!small.pop(value) && small.empty());
+        CHECK(small.push(9) && small.pop(value) && value == 9);
+
+        // A 2^26 element capacity does not fit the index bits and must fail before any allocation is attempted
+        CHECK(test::throws<std::length_error>([] { Container c(std::size_t(1) << 26); }));
+        CHECK(test::throws<std::length_error>([] { Container c(std::size_t(-1) / 2); }));
+        CHECK(test::throws<std::length_error>([] { Container c(std::size_t(-1)); }));
+
+        // A small capacity keeps producers hitting full and consumers hitting empty
+        Container c(64);
+        std::unique_ptr<std::atomic<int>[]> seen(new std::atomic<int>[producers * per_producer]());
+        std::atomic<std::uint32_t> popped{0};
+        std::vector<std::thread> threads;
+        for(unsigned p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                for(std::uint32_t i = 0; i < per_producer; i++) {
+                    while(!c.push(p * per_producer + i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for(unsigned t = 0; t < consumers; t++) {
+            threads.emplace_back([&] {
+                std::uint32_t v;
+                while(popped.load(std::memory_order_relaxed) < producers * per_producer) {
+                    if(c.pop(v)) {
+                        seen[v].fetch_add(1, std::memory_order_relaxed);
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for(auto& t : threads) {
+            t.join();
+        }
+        for(std::uint32_t v = 0; v < producers * per_producer; v++) {
+            CHECK(seen[v].load() == 1);
+        }
+        CHECK(c.empty() && !c.pop(value));
+    }
+}
+
+int main() {
+    run<floating_treiber_stack<std::uint32_t>>();
+    run<floating_ms_queue<std::uint32_t>>();
+}
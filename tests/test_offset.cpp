@@ -0,0 +1,45 @@
+// floating_offset: indices the representation cannot hold exactly are rejected instead of aliasing other elements,
+// and null offsets do not index a pool.
+
+#include <cstddef>
+#include <stdexcept>
+
+#include <floating_offset.hpp>
+
+#include "test.hpp"
+
+using based::floating_offset;
+using based::floating_offset_pool;
+
+int main() {
+    using offset = floating_offset<int, float>;
+    constexpr std::size_t max = offset::max_elements;
+    CHECK(max == std::size_t(1) << 24);
+    CHECK(offset(max - 1).index() == max - 1);
+    CHECK(test::throws<std::length_error>([] { offset o(max); (void)o; }));
+    CHECK(test::throws<std::length_error>([] { offset o(max + 1); (void)o; }));
+
+    int elements[4] = {};
+    CHECK(offset(elements, elements + 3).index() == 3);
+    CHECK(!offset(elements, nullptr));
+    CHECK(test::throws<std::length_error>([&] { offset o(elements + 1, elements); (void)o; }));
+
+    // Indexing a pool with the null offset is a precondition violation, not a read of element NaN
+    floating_offset_pool<int> ints;
+    offset first = ints.make(7);
+    CHECK(ints[first] == 7);
+    CHECK(test::aborts([&] { (void)ints[offset(nullptr)]; }));
+    CHECK(test::aborts([&] { (void)static_cast<const floating_offset_pool<int>&>(ints)[offset(based::nanptr)]; }));
+
+    #ifdef __FLT16_MANT_DIG__
+    // A pool of 2 byte offsets fills up at 2^11 elements
+    using small_offset = floating_offset<int, _Float16>;
+    floating_offset_pool<int, _Float16> pool;
+    for(std::size_t i = 0; i < pool.max_elements; i++) {
+        CHECK(pool.make(int(i)).index() == i);
+    }
+    CHECK(test::throws<std::length_error>([&] { pool.make(0); }));
+    CHECK(pool.size() == pool.max_elements);
+    CHECK(pool[small_offset(pool.max_elements - 1)] == int(pool.max_elements - 1));
+    #endif
+}
@@ -0,0 +1,110 @@
+// floating_pointer_map: random inserts, lookups and erase-heavy churn agree with std::unordered_map, reusing
+// tombstones and rehashing along the way, and NaN and negative null keys are canonicalized.
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <floating_pointer_map.hpp>
+
+#include "test.hpp"
+
+using based::floating_pointer;
+using based::floating_pointer_map;
+
+namespace {
+    using map = floating_pointer_map<int, int>;
+
+    bool same(const map& m, const std::unordered_map<int*, int>& reference) {
+        if(m.size() != reference.size()) {
+            return false;
+        }
+        std::size_t seen = 0;
+        for(const auto& [key, value] : m) {
+            auto it = reference.find(key);
+            if(it == reference.end() || it->second != value) {
+                return false;
+            }
+            seen++;
+        }
+        return seen == reference.size();
+    }
+}
+
+int main() {
+    static int objects[1 << 14];
+    std::mt19937_64 random(19);
+    map m;
+    std::unordered_map<int*, int> reference;
+
+    // Growth, then churn over a small key range that fills groups with tombstones and forces same-size rehashes,
+    // then growth again on top of the tombstones
+    struct phase {
+        std::size_t keys;
+        unsigned insert_percent;
+        std::size_t operations;
+    };
+    for(phase p : {phase{1 << 14, 80, 40000}, phase{1 << 14, 20, 40000}, phase{700, 50, 200000},
+                   phase{1 << 14, 90, 40000}, phase{1 << 14, 5, 60000}}) {
+        std::size_t capacity_before = m.capacity();
+        for(std::size_t i = 0; i < p.operations; i++) {
+            int* key = &objects[random() % p.keys];
+            if(random() % 100 < p.insert_percent) {
+                int value = int(i);
+                CHECK(m.try_emplace(key, value).second == reference.try_emplace(key, value).second);
+            } else if(random() % 2) {
+                CHECK(m.erase(key) == reference.erase(key));
+            } else {
+                auto it = m.find(key);
+                CHECK((it == m.end()) == (reference.count(key) == 0));
+                if(it != m.end()) {
+                    CHECK(it->second == reference[key]);
+                    m.erase(it);
+                    reference.erase(key);
+                }
+            }
+            int* probe = &objects[random() % p.keys];
+            auto found = m.find(probe);
+            CHECK((found == m.end()) == (reference.count(probe) == 0));
+            CHECK(found == m.end() || found->second == reference[probe]);
+        }
+        CHECK(same(m, reference));
+        // Churn over a few hundred keys must clean tombstones up in place rather than keep doubling
+        if(p.keys == 700) {
+            CHECK(m.capacity() <= capacity_before);
+        }
+    }
+
+    // Erasing everything through iterators
+    for(auto it = m.begin(); it != m.end();) {
+        it = m.erase(it);
+    }
+    CHECK(m.empty() && m.begin() == m.end());
+
+    // Special keys: every NaN is nanptr, negativenullptr is nullptr, negative pointers are their own keys
+    map special;
+    special[nullptr] = 1;
+    CHECK(special.count(based::negativenullptr) == 1 && special[based::negativenullptr] == 1);
+    special[based::nanptr] = 2;
+    floating_pointer<int> other_nan = based::detail::pointer_from_bits<int>(0x7ff800000000abcd);
+    floating_pointer<int> negative_nan = based::detail::pointer_from_bits<int>(0xfff8000000000001);
+    CHECK(special.count(other_nan) == 1 && special.count(negative_nan) == 1);
+    CHECK(special.find(other_nan)->second == 2);
+    CHECK(based::detail::pointer_bits(special.find(other_nan)->first)
+          == based::detail::pointer_bits(floating_pointer<int>(based::nanptr)));
+    floating_pointer<int> p = &objects[0];
+    special[p] = 3;
+    special[-p] = 4;
+    special[based::infinityptr] = 5;
+    CHECK(special.size() == 5 && special[p] == 3 && special[-p] == 4 && special[based::infinityptr] == 5);
+    CHECK(special.erase(negative_nan) == 1 && !special.contains(based::nanptr));
+    CHECK(special.erase(based::negativenullptr) == 1 && !special.contains(nullptr));
+    CHECK(special.size() == 3);
+
+    map copy = special;
+    CHECK(copy.size() == 3 && copy[-p] == 4);
+    map moved = std::move(copy);
+    CHECK(copy.empty() && moved.size() == 3);
+}
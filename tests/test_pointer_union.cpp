@@ -0,0 +1,48 @@
+// floating_pointer_union: each alternative round-trips its index and address, nulls compare equal, and addresses wider
+// than 48 bits are rejected.
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include <floating_pointer_union.hpp>
+#include <floating_value.hpp>
+
+#include "test.hpp"
+
+using based::floating_pointer;
+using based::floating_pointer_union;
+using based::floating_value;
+
+namespace {
+    struct a { int x; };
+    struct b { double y; };
+    struct c { char z; };
+}
+
+int main() {
+    using node = floating_pointer_union<a, b, c>;
+    a first{1};
+    b second{2};
+    c third{'3'};
+    node u = &first;
+    CHECK(u.index() == 0 && u.holds<a>() && u.get<a>()->x == 1);
+    CHECK(u.get_if<b>() == nullptr);
+    u = &second;
+    CHECK(u.index() == 1 && u.get_if<b>()->y == 2);
+    u = &third;
+    CHECK(u.index() == 2 && u.get<c>()->z == '3');
+    CHECK(u.visit([](auto p) { return p != nullptr; }));
+    CHECK(std::isnan(double(u)));
+    CHECK(node(floating_pointer<a>(nullptr)) == node(floating_pointer<c>(nullptr)));
+    CHECK(!node() && node() == nullptr);
+    CHECK(node(&first) != node(&second));
+
+    // Both share one layout: alternative i of a union is tag i of a floating_value
+    floating_value v(floating_pointer<c>(&third), 2);
+    CHECK(v.raw_bits() == based::detail::to_bits(double(u)));
+    // and reject the same addresses, which would otherwise be truncated to a different pointer
+    auto high = floating_pointer<b>(reinterpret_cast<b*>(std::uintptr_t(1) << 48));
+    CHECK(test::throws<std::out_of_range>([&] { node n(high); }));
+    CHECK(test::throws<std::out_of_range>([&] { floating_value w(high, 1); }));
+}
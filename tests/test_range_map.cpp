@@ -0,0 +1,164 @@
+// floating_range_map: random inserts, erases and interior lookups agree with a std::map of ranges, including ranges
+// spanning many pages, rejected overlaps and the pages an erased range leaves uncovered.
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+
+#include <floating_range_map.hpp>
+
+#include "test.hpp"
+
+using based::floating_pointer;
+using based::floating_range_map;
+
+namespace {
+    using map = floating_range_map<int>;
+    // first byte -> (bytes, value)
+    using reference_map = std::map<std::uintptr_t, std::pair<std::size_t, int>>;
+
+    constexpr std::uintptr_t page = 4096;
+
+    // Addresses are only looked up, never dereferenced
+    floating_pointer<std::byte> at(std::uintptr_t address) {
+        return reinterpret_cast<std::byte*>(address);
+    }
+
+    const reference_map::value_type* reference_find(const reference_map& reference, std::uintptr_t address) {
+        auto after = reference.upper_bound(address);
+        if(after == reference.begin()) {
+            return nullptr;
+        }
+        auto it = std::prev(after);
+        return address - it->first < it->second.first ? &*it : nullptr;
+    }
+    bool reference_overlaps(const reference_map& reference, std::uintptr_t begin, std::size_t bytes) {
+        auto after = reference.lower_bound(begin + bytes);
+        return after != reference.begin() && std::prev(after)->first + std::prev(after)->second.first > begin;
+    }
+
+    bool finds_like(const map& m, const reference_map& reference, std::uintptr_t address) {
+        const map::range* found = m.find(at(address));
+        const reference_map::value_type* expected = reference_find(reference, address);
+        if(!expected) {
+            return found == nullptr;
+        }
+        return found && std::uintptr_t(found->first) == expected->first && found->bytes == expected->second.first &&
+               found->value == expected->second.second;
+    }
+}
+
+int main() {
+    map m;
+    CHECK(m.empty() && !m.find(at(page)));
+
+    // A range over five pages: the pages after its first are found through their covering range
+    CHECK(m.insert(at(3 * page + 100), 4 * page + 50, 1));
+    CHECK(!m.contains(at(3 * page + 99)));
+    for(std::uintptr_t a = 3 * page + 100; a < 7 * page + 150; a += 97) {
+        CHECK(m.find(at(a)) && m.find(at(a))->value == 1);
+    }
+    CHECK(m.contains(at(7 * page + 149)) && !m.contains(at(7 * page + 150)));
+
+    // Overlaps are rejected whether they hold the start, start inside, or swallow the range whole
+    CHECK(!m.insert(at(3 * page + 99), 2, 2));
+    CHECK(!m.insert(at(5 * page), 1, 2));
+    CHECK(!m.insert(at(7 * page + 149), 10, 2));
+    CHECK(!m.insert(at(page), 10 * page, 2));
+    // Empty, past 2^48 and non-address ranges are rejected too
+    CHECK(!m.insert(at(10 * page), 0, 2));
+    CHECK(!m.insert(at((std::uintptr_t(1) << 48) - 8), 9, 2));
+    CHECK(!m.insert(-at(10 * page), 1, 2));
+    CHECK(!m.insert(floating_pointer<std::byte>(based::nanptr), 1, 2));
+    CHECK(m.size() == 1);
+    // Adjacent ranges on both sides fit, the one after sharing the last page
+    CHECK(m.insert(at(3 * page), 100, 3));
+    CHECK(m.insert(at(7 * page + 150), 10, 4));
+    CHECK(m.find(at(7 * page + 149))->value == 1 && m.find(at(7 * page + 150))->value == 4);
+
+    // Erasing needs the exact start, and clears the covering entries of the pages the range spanned
+    CHECK(m.erase(at(3 * page + 101)) == 0);
+    CHECK(m.erase(at(3 * page + 100)) == 1);
+    CHECK(m.erase(at(3 * page + 100)) == 0);
+    for(std::uintptr_t a = 3 * page + 100; a < 7 * page + 150; a += 97) {
+        CHECK(!m.contains(at(a)));
+    }
+    CHECK(m.contains(at(3 * page)) && m.contains(at(7 * page + 150)) && m.size() == 2);
+    // A shorter range in the same place is not found through stale entries
+    CHECK(m.insert(at(3 * page + 100), 10, 5));
+    CHECK(!m.contains(at(5 * page)) && m.find(at(3 * page + 109))->value == 5);
+    m.clear();
+    CHECK(m.empty() && !m.contains(at(3 * page)));
+
+    // Random ranges over two regions far enough apart to use different tables at every level, most within a page
+    // and some spanning dozens
+    std::mt19937_64 random(25);
+    reference_map reference;
+    const std::uintptr_t regions[] = {std::uintptr_t(1) << 20, (std::uintptr_t(1) << 47) + (std::uintptr_t(1) << 36)};
+    const std::uintptr_t region_bytes = 256 * page;
+    auto random_address = [&] { return regions[random() % 2] + random() % region_bytes; };
+    for(int i = 0; i < 30000; i++) {
+        switch(random() % 4) {
+            case 0: {
+                std::uintptr_t begin = random_address();
+                std::size_t bytes = random() % 8 == 0 ? 1 + random() % (40 * page) : 1 + random() % 300;
+                bool fits = !reference_overlaps(reference, begin, bytes);
+                CHECK(m.insert(at(begin), bytes, i) == fits);
+                if(fits) {
+                    reference.emplace(begin, std::make_pair(bytes, i));
+                }
+                break;
+            }
+            case 1: {
+                if(reference.empty()) {
+                    break;
+                }
+                // Erase an existing range, its ends covering whole pages that must be found empty afterwards
+                auto it = reference.lower_bound(random_address());
+                if(it == reference.end()) {
+                    it = reference.begin();
+                }
+                std::uintptr_t begin = it->first;
+                std::size_t bytes = it->second.first;
+                CHECK(m.erase(at(begin)) == 1);
+                reference.erase(it);
+                for(std::uintptr_t a = begin; a < begin + bytes; a += page) {
+                    CHECK(finds_like(m, reference, a));
+                }
+                CHECK(finds_like(m, reference, begin + bytes - 1));
+                break;
+            }
+            case 2: {
+                std::uintptr_t address = random_address();
+                CHECK(m.erase(at(address)) == reference.erase(address));
+                break;
+            }
+            default:
+                for(int j = 0; j < 8; j++) {
+                    CHECK(finds_like(m, reference, random_address()));
+                }
+                break;
+        }
+        CHECK(m.size() == reference.size());
+    }
+    std::size_t seen = 0;
+    m.for_each([&](const map::range& r) {
+        auto it = reference.find(std::uintptr_t(r.first));
+        CHECK(it != reference.end() && it->second.first == r.bytes && it->second.second == r.value);
+        seen++;
+    });
+    CHECK(seen == reference.size());
+
+    // Every byte near every remaining range boundary
+    for(const auto& [begin, entry] : reference) {
+        for(std::uintptr_t a = begin - 2; a != begin + 2; a++) {
+            CHECK(finds_like(m, reference, a));
+        }
+        for(std::uintptr_t a = begin + entry.first - 2; a != begin + entry.first + 2; a++) {
+            CHECK(finds_like(m, reference, a));
+        }
+    }
+}
@@ -0,0 +1,97 @@
+// floating_rb_tree: random inserts, erases and lookups agree with std::map and keep the red-black invariants.
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <utility>
+
+#include <floating_rb_tree.hpp>
+
+#include "test.hpp"
+
+using based::floating_rb_tree;
+
+namespace {
+    using tree = floating_rb_tree<int, int>;
+
+    bool same(const tree& t, const std::map<int, int>& reference) {
+        if(t.size() != reference.size()) {
+            return false;
+        }
+        auto it = reference.begin();
+        for(const auto& [key, value] : t) {
+            if(it == reference.end() || it->first != key || it->second != value) {
+                return false;
+            }
+            ++it;
+        }
+        return it == reference.end();
+    }
+}
+
+int main() {
+    tree t;
+    std::map<int, int> reference;
+    std::uint64_t state = 1;
+    auto next = [&](int range) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        return int((state >> 33) % std::uint64_t(range));
+    };
+    // Phases alternate between mostly inserting and mostly erasing, so erase_fixup sees every shape of tree
+    for(int phase = 0; phase < 8; phase++) {
+        int insert_percent = phase % 2 ? 30 : 70;
+        for(int i = 0; i < 3000; i++) {
+            int key = next(1000);
+            if(next(100) < insert_percent) {
+                bool inserted = t.try_emplace(key, i).second;
+                CHECK(inserted == reference.try_emplace(key, i).second);
+            } else {
+                CHECK(t.erase(key) == reference.erase(key));
+            }
+            CHECK(t.valid());
+            int probe = next(1000);
+            auto found = t.find(probe);
+            CHECK((found == t.end()) == (reference.count(probe) == 0));
+            CHECK(found == t.end() || found->second == reference[probe]);
+        }
+        CHECK(same(t, reference));
+    }
+
+    // Erasing through iterators: every other element, then the rest
+    for(int i = 0; i < 500; i++) {
+        t[i * 2] = i;
+        reference[i * 2] = i;
+    }
+    for(auto it = t.begin(); it != t.end();) {
+        it = t.erase(it);
+        if(it != t.end()) {
+            ++it;
+        }
+        CHECK(t.valid());
+    }
+    for(auto it = reference.begin(); it != reference.end();) {
+        it = reference.erase(it);
+        if(it != reference.end()) {
+            ++it;
+        }
+    }
+    CHECK(same(t, reference));
+    auto last = t.erase(std::next(t.begin(), std::ptrdiff_t(t.size() - 1)));
+    reference.erase(std::prev(reference.end()));
+    CHECK(last == t.end());
+    CHECK(t.valid() && same(t, reference));
+
+    // Copies are deep and keep their colors; moves leave the source empty
+    tree copy = t;
+    CHECK(copy.valid() && same(copy, reference));
+    copy.erase(copy.begin());
+    CHECK(copy.size() + 1 == t.size() && same(t, reference));
+    tree moved = std::move(copy);
+    CHECK(moved.valid() && copy.empty() && copy.begin() == copy.end());
+    copy = moved;
+    CHECK(copy.valid() && copy.size() == moved.size());
+    moved = std::move(t);
+    CHECK(moved.valid() && same(moved, reference));
+    moved.clear();
+    CHECK(moved.empty() && moved.valid());
+}
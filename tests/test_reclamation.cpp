@@ -0,0 +1,94 @@
+// floating_epoch_domain and floating_hazard_domain: nodes retired while readers traverse them are freed exactly once,
+// only after no reader can reach them, and all of them are freed once the threads are gone. Meant to be run under
+// -fsanitize=thread.
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <floating_reclamation.hpp>
+
+#include "test.hpp"
+
+using based::floating_epoch_domain;
+using based::floating_hazard_domain;
+using based::floating_pointer;
+
+namespace {
+    constexpr unsigned readers = 3;
+    constexpr unsigned writers = 2;
+    constexpr int replacements = 5000;
+    constexpr int total = writers * replacements + 1;
+
+    // One count per node ever allocated, so a double free shows up as a 2
+    std::unique_ptr<std::atomic<int>[]> frees;
+
+    struct node {
+        static constexpr unsigned live_mark = 0x600dcafe;
+        int id;
+        std::atomic<unsigned> mark{live_mark};
+        explicit node(int id) : id(id) {}
+        ~node() {
+            mark.store(0, std::memory_order_relaxed);
+            frees[id].fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    template<typename Domain>
+    void run() {
+        frees.reset(new std::atomic<int>[total]());
+        Domain& domain = Domain::instance();
+        std::atomic<floating_pointer<node>> shared(new node(0));
+        std::atomic<int> next_id{1};
+        std::atomic<bool> done{false};
+        std::atomic<bool> saw_freed{false};
+
+        std::vector<std::thread> threads;
+        for(unsigned r = 0; r < readers; r++) {
+            threads.emplace_back([&] {
+                while(!done.load(std::memory_order_acquire)) {
+                    auto guard = domain.pin();
+                    floating_pointer<node> n = guard.protect(0, shared);
+                    // A node is only freed once no guard can still reach it
+                    if(n->mark.load(std::memory_order_relaxed) != node::live_mark
+                       || frees[n->id].load(std::memory_order_relaxed) != 0) {
+                        saw_freed = true;
+                    }
+                }
+            });
+        }
+        for(unsigned w = 0; w < writers; w++) {
+            threads.emplace_back([&] {
+                for(int i = 0; i < replacements; i++) {
+                    floating_pointer<node> fresh = new node(next_id++);
+                    floating_pointer<node> old = shared.exchange(fresh, std::memory_order_acq_rel);
+                    domain.retire(old);
+                }
+            });
+        }
+        for(unsigned w = 0; w < writers; w++) {
+            threads[readers + w].join();
+        }
+        done = true;
+        for(unsigned r = 0; r < readers; r++) {
+            threads[r].join();
+        }
+        CHECK(!saw_freed);
+
+        // Exited threads left their retired nodes behind; with no one pinned they all go within a few collections
+        domain.retire(shared.exchange(nullptr));
+        for(int i = 0; i < 4; i++) {
+            domain.collect();
+        }
+        for(int id = 0; id < total; id++) {
+            CHECK(frees[id].load() == 1);
+        }
+    }
+}
+
+int main() {
+    run<floating_epoch_domain>();
+    run<floating_hazard_domain>();
+}
@@ -0,0 +1,51 @@
+// relayout: the returned root keeps the sign bit and tag of the root passed in, as interior links do.
+
+#include <cstdint>
+
+#include <floating_relayout.hpp>
+
+#include "test.hpp"
+
+using based::floating_arena;
+using based::floating_pointer;
+using based::relayout_order;
+
+namespace {
+    struct node {
+        int key;
+        floating_pointer<node> left;
+        floating_pointer<node> right;
+    };
+}
+
+int main() {
+    node a{1, nullptr, nullptr};
+    node c{3, nullptr, nullptr};
+    node b{2, floating_pointer<node>(&a).with_tag(3), -floating_pointer<node>(&c)};
+    auto edges = [](node& n, auto&& f) { f(n.left); f(n.right); };
+    floating_arena arena;
+    for(bool negative : {false, true}) {
+        for(std::uintptr_t tag : {0, 1, 5}) {
+            floating_pointer<node> root = floating_pointer<node>(&b).with_tag(tag);
+            if(negative) {
+                root = -root;
+            }
+            for(int pass = 0; pass < 3; pass++) {
+                floating_pointer<node> copy;
+                if(pass == 0) {
+                    copy = based::relayout(root, arena, edges);
+                } else if(pass == 1) {
+                    copy = based::relayout(root, arena, edges, relayout_order::depth_first);
+                } else {
+                    copy = based::relayout(root, arena, edges, [](const node& n) { return n.key; });
+                }
+                CHECK(signbit(copy) == negative);
+                CHECK(abs(copy).tag() == tag);
+                node* moved = abs(copy).untagged();
+                CHECK(moved != &b && moved->key == 2);
+                CHECK(abs(moved->left).tag() == 3 && abs(moved->left).untagged()->key == 1);
+                CHECK(signbit(moved->right) && abs(moved->right)->key == 3);
+            }
+        }
+    }
+}
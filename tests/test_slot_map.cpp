@@ -0,0 +1,141 @@
+// floating_slot_map: handles go stale on erase and stay stale, a slot whose generation runs out is retired instead of
+// reused, and random inserts and erases agree with a record of every handle issued while elements move and die.
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <floating_slot_map.hpp>
+
+#include "test.hpp"
+
+using based::floating_slot_map;
+
+namespace {
+    // Counts live instances, so leaks and double destruction show up
+    struct counted {
+        static inline int live = 0;
+        int value;
+        explicit counted(int v) : value(v) {
+            live++;
+        }
+        counted(const counted& other) : value(other.value) {
+            live++;
+        }
+        counted(counted&& other) noexcept : value(other.value) {
+            live++;
+        }
+        counted& operator=(const counted&) = default;
+        ~counted() {
+            live--;
+        }
+    };
+    using map = floating_slot_map<counted>;
+    using handle = map::handle;
+
+    constexpr std::uint32_t max_generation = (std::uint32_t(1) << 19) - 1;
+}
+
+int main() {
+    {
+        map m;
+        handle null;
+        CHECK(!null && null == handle(based::nanptr) && !m.contains(null) && !m.get(null));
+
+        // Stale handles after erase, including once the slot holds a new element
+        handle a = m.emplace(1);
+        handle b = m.emplace(2);
+        CHECK(a && b && a != b && m.get(a)->value == 1 && m.get(b)->value == 2);
+        CHECK(m.erase(a) && !m.erase(a));
+        CHECK(!m.contains(a) && !m.get(a) && m.size() == 1);
+        handle c = m.emplace(3);
+        CHECK(c != a && !m.contains(a) && m.get(c)->value == 3);
+        // Handles survive a round trip through double, as the NaN they are
+        double stored = double(c);
+        CHECK(stored != stored && handle::from_double(stored) == c && m.get(handle::from_double(stored))->value == 3);
+
+        // Inserting relocates elements; handles still resolve
+        std::vector<handle> many;
+        for(int i = 0; i < 1000; i++) {
+            many.push_back(m.emplace(i));
+        }
+        for(int i = 0; i < 1000; i++) {
+            CHECK(m.get(many[i])->value == i);
+        }
+        CHECK(counted::live == int(m.size()));
+
+        // A copy resolves the same handles to its own elements; erasing from one leaves the other alone
+        map copy = m;
+        CHECK(copy.get(c)->value == 3 && copy.get(c) != m.get(c));
+        CHECK(copy.erase(b) && m.contains(b) && !copy.contains(b));
+        map moved = std::move(copy);
+        CHECK(moved.get(c)->value == 3 && !moved.contains(b) && copy.empty() && !copy.contains(c));
+
+        // clear leaves every handle stale and new elements with fresh generations
+        m.clear();
+        CHECK(m.empty() && !m.contains(b) && !m.contains(c) && !m.contains(many[0]));
+        handle d = m.emplace(4);
+        CHECK(d != b && d != c && !m.contains(many[0]));
+    }
+    CHECK(counted::live == 0);
+
+    {
+        // Generation wraparound: cycle one slot through every generation. Its last element gets max_generation, and
+        // once that is erased the slot is retired, so no later element reuses a handle the first slot ever gave out.
+        map m;
+        handle first = m.emplace(0);
+        handle previous = first;
+        for(std::uint32_t g = 2; g <= max_generation; g++) {
+            CHECK(m.erase(previous));
+            handle h = m.emplace(int(g));
+            CHECK(h != previous && !m.contains(previous));
+            previous = h;
+        }
+        handle last = previous;
+        CHECK(m.get(last)->value == int(max_generation) && !m.contains(first));
+        CHECK(m.erase(last));
+        handle next = m.emplace(-1);
+        CHECK(next != first && next != last && !m.contains(first) && !m.contains(last));
+        // The retired slot is skipped for good, while the new one keeps being reused
+        for(int i = 0; i < 100; i++) {
+            handle h = m.emplace(i);
+            CHECK(h != first && h != last && !m.contains(last));
+            CHECK(m.erase(h));
+        }
+        CHECK(m.size() == 1 && m.get(next)->value == -1);
+    }
+    CHECK(counted::live == 0);
+
+    {
+        // Random inserts and erases, keeping every handle ever issued to check stale ones too
+        std::mt19937_64 random(8);
+        map m;
+        std::vector<std::pair<handle, int>> issued;
+        std::vector<bool> alive;
+        for(int i = 0; i < 50000; i++) {
+            if(issued.empty() || random() % 3) {
+                issued.emplace_back(m.emplace(i), i);
+                alive.push_back(true);
+            } else {
+                std::size_t j = random() % issued.size();
+                CHECK(m.erase(issued[j].first) == alive[j]);
+                alive[j] = false;
+            }
+            std::size_t j = random() % issued.size();
+            if(alive[j]) {
+                CHECK(m.get(issued[j].first)->value == issued[j].second);
+            } else {
+                CHECK(!m.contains(issued[j].first));
+            }
+        }
+        std::size_t live = 0;
+        for(std::size_t j = 0; j < issued.size(); j++) {
+            CHECK(m.contains(issued[j].first) == alive[j]);
+            live += alive[j];
+        }
+        CHECK(m.size() == live && counted::live == int(live));
+    }
+    CHECK(counted::live == 0);
+}
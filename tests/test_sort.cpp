@@ -0,0 +1,110 @@
+// floating_sort: agrees bit for bit with std::sort under total_order_less on both sides of the switch from sorting
+// networks to radix sort, and total_order_less itself orders NaNs, signed nulls and negative pointers.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <floating_sort.hpp>
+
+#include "test.hpp"
+
+using based::floating_pointer;
+using based::total_order_less;
+
+namespace {
+    using pointer = floating_pointer<int>;
+
+    int objects[1 << 12];
+
+    pointer nan_with_payload(std::uint64_t payload, bool negative) {
+        return based::detail::pointer_from_bits<int>(based::detail::quiet_nan_bits | payload |
+                                                     (negative ? 0x8000000000000000 : 0));
+    }
+
+    // Mostly addresses into one array, where radix passes over shared bytes are skipped, with some of everything else
+    pointer random_pointer(std::mt19937_64& random, bool specials) {
+        pointer p = &objects[random() % (sizeof(objects) / sizeof(objects[0]))];
+        switch(specials ? random() % 16 : 0) {
+            case 1: return -p;
+            case 2: return nullptr;
+            case 3: return based::negativenullptr;
+            case 4: return based::infinityptr;
+            case 5: return based::negativeinfinityptr;
+            case 6: return based::nanptr;
+            case 7: return nan_with_payload(random() % 1000, random() % 2);
+            default: return p;
+        }
+    }
+
+    bool sorts_like_std(std::vector<pointer> values) {
+        std::vector<pointer> reference = values;
+        std::sort(reference.begin(), reference.end(), total_order_less());
+        based::floating_sort(values.data(), values.data() + values.size());
+        for(std::size_t i = 0; i < values.size(); i++) {
+            if(based::detail::pointer_bits(values[i]) != based::detail::pointer_bits(reference[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    // Strictly increasing under total_order_less, each a different bit pattern
+    pointer low = &objects[1];
+    pointer high = &objects[2];
+    const pointer chain[] = {nan_with_payload(5, true), nan_with_payload(1, true), based::negativeinfinityptr, -high,
+                             -low, based::negativenullptr, nullptr, low, high, based::infinityptr, based::nanptr,
+                             nan_with_payload(1, false), nan_with_payload(5, false)};
+    const std::size_t length = sizeof(chain) / sizeof(chain[0]);
+    total_order_less less;
+    for(std::size_t i = 0; i < length; i++) {
+        CHECK(!less(chain[i], chain[i]));
+        for(std::size_t j = i + 1; j < length; j++) {
+            CHECK(less(chain[i], chain[j]));
+            CHECK(!less(chain[j], chain[i]));
+        }
+    }
+    // Unlike operator<, which equates the signed nulls and leaves NaN unordered
+    CHECK(!(pointer(based::negativenullptr) < pointer(nullptr)));
+    CHECK(!(pointer(based::nanptr) < low) && !(low < pointer(based::nanptr)));
+    // -nanptr is the negative NaN with an empty payload, first of all
+    CHECK(less(-pointer(based::nanptr), pointer(based::negativeinfinityptr)));
+    CHECK(less(nan_with_payload(1, true), -pointer(based::nanptr)));
+
+    std::vector<pointer> reversed(chain, chain + length);
+    std::reverse(reversed.begin(), reversed.end());
+    CHECK(sorts_like_std(reversed));
+
+    // Every size through the network and merge path, across radix_threshold, and into the radix path
+    std::mt19937_64 random(20);
+    for(std::size_t n = 0; n <= 600; n++) {
+        for(bool specials : {false, true}) {
+            std::vector<pointer> values(n);
+            for(pointer& p : values) {
+                p = random_pointer(random, specials);
+            }
+            CHECK(sorts_like_std(values));
+        }
+    }
+    for(std::size_t n : {based::detail::radix_threshold - 1, based::detail::radix_threshold,
+                         based::detail::radix_threshold + 1, std::size_t(1) << 16}) {
+        // Already sorted, reversed, all equal, and random
+        std::vector<pointer> values(n);
+        for(std::size_t i = 0; i < n; i++) {
+            values[i] = &objects[i % (sizeof(objects) / sizeof(objects[0]))];
+        }
+        std::sort(values.begin(), values.end(), total_order_less());
+        CHECK(sorts_like_std(values));
+        std::reverse(values.begin(), values.end());
+        CHECK(sorts_like_std(values));
+        CHECK(sorts_like_std(std::vector<pointer>(n, based::negativenullptr)));
+        for(pointer& p : values) {
+            p = random_pointer(random, true);
+        }
+        CHECK(sorts_like_std(values));
+    }
+}
@@ -0,0 +1,39 @@
+// floating_span: stride and chunk views cover the right elements, and a zero stride or chunk size is rejected.
+
+#include <cstddef>
+
+#include <floating_span.hpp>
+
+#include "test.hpp"
+
+using based::floating_span;
+
+int main() {
+    int values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    floating_span<int> span(values);
+
+    auto every_third = span.stride(3);
+    CHECK(every_third.size() == 4);
+    CHECK(every_third[0] == 0 && every_third[3] == 9);
+    auto backwards = span.stride(-4);
+    CHECK(backwards.size() == 3);
+    CHECK(backwards[0] == 9 && backwards[1] == 5 && backwards[2] == 1);
+    CHECK(every_third.stride(2).size() == 2);
+    CHECK(every_third.stride(2)[1] == 6);
+
+    auto chunks = span.chunk(4);
+    CHECK(chunks.size() == 3);
+    CHECK(chunks[2].size() == 2 && chunks[2][1] == 9);
+    std::size_t seen = 0;
+    for(auto c : chunks) {
+        seen += c.size();
+    }
+    CHECK(seen == 10);
+    CHECK(span.stride(2).chunk(3).size() == 2);
+    CHECK(floating_span<int>().chunk(1).empty());
+
+    CHECK(test::aborts([&] { (void)span.stride(0); }));
+    CHECK(test::aborts([&] { (void)span.stride(2).stride(0); }));
+    CHECK(test::aborts([&] { (void)span.chunk(0); }));
+    CHECK(test::aborts([&] { (void)span.stride(-1).chunk(0); }));
+}
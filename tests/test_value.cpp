@@ -0,0 +1,34 @@
+// floating_value: tagged pointers round-trip as pointers, and tags or addresses the layout cannot hold throw.
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <floating_value.hpp>
+
+#include "test.hpp"
+
+using based::floating_pointer;
+using based::floating_value;
+
+int main() {
+    double object = 0;
+    floating_pointer<double> p = &object;
+    for(unsigned tag = 1; tag <= floating_value::max_tag; tag++) {
+        floating_value v(p, tag);
+        CHECK(v.is_pointer());
+        CHECK(!v.is_number());
+        CHECK(v.tag() == tag);
+        CHECK(v.has_tag(tag));
+        CHECK(v.as_pointer<double>() == p);
+    }
+    floating_value null(floating_pointer<double>(nullptr), 1);
+    CHECK(null.is_pointer());
+    CHECK(null.as_pointer<double>() == nullptr);
+
+    // Tag 0 would box to a NaN number and tag 8 would carry into the exponent
+    CHECK(test::throws<std::invalid_argument>([&] { floating_value v(p, 0); }));
+    CHECK(test::throws<std::invalid_argument>([&] { floating_value v(p, floating_value::max_tag + 1); }));
+    // Addresses above 48 bits would be truncated
+    auto high = floating_pointer<double>(reinterpret_cast<double*>(std::uintptr_t(1) << 48));
+    CHECK(test::throws<std::out_of_range>([&] { floating_value v(high, 1); }));
+}